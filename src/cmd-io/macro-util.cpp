@@ -1,4 +1,7 @@
 #include "cmd-io/macro-util.h"
+#include <algorithm>
+#include <map>
+#include <string_view>
 
 /* Current macro action [1024] */
 std::vector<char> macro_buffers;
@@ -18,42 +21,96 @@ bool get_com_no_macros = false;
 /* Determine if any macros have ever started with a given character */
 static bool macro_uses[256];
 
-/* Find the macro (if any) which exactly matches the given pattern */
-int macro_find_exact(concptr pat)
+namespace {
+/*!
+ * @brief マクロのトリガーを1文字ずつ辿る木の節
+ * @details 根は空文字列に対応し、子は次の1文字で引く.
+ */
+struct MacroTrieNode {
+    std::map<char, int> children;
+    int exact = -1; //!< この節で終わるトリガーを持つマクロの番号
+    int first = -1; //!< この節以下で終わるトリガーを持つマクロの最小の番号
+    int first_longer = -1; //!< この節より下で終わるトリガーを持つマクロの最小の番号
+};
+
+std::vector<MacroTrieNode> macro_trie(1);
+
+int min_index(int index1, int index2)
 {
-    if (!macro_uses[(byte)(pat[0])]) {
-        return -1;
-    }
+    return (index1 < 0) ? index2 : std::min(index1, index2);
+}
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!streq(macro_patterns[i], pat)) {
+/*!
+ * @brief マクロのトリガーを木に加える
+ * @param pat トリガー
+ * @param index マクロの番号
+ */
+void macro_trie_insert(std::string_view pat, int index)
+{
+    auto node = 0;
+    for (const auto ch : pat) {
+        macro_trie[node].first = min_index(macro_trie[node].first, index);
+        macro_trie[node].first_longer = min_index(macro_trie[node].first_longer, index);
+        const auto it = macro_trie[node].children.find(ch);
+        if (it != macro_trie[node].children.end()) {
+            node = it->second;
             continue;
         }
 
-        return i;
+        const auto child = static_cast<int>(macro_trie.size());
+        macro_trie[node].children.emplace(ch, child);
+        macro_trie.emplace_back();
+        node = child;
     }
 
-    return -1;
+    macro_trie[node].exact = index;
+    macro_trie[node].first = min_index(macro_trie[node].first, index);
 }
 
-/*
- * Find the first macro (if any) which contains the given pattern
+/*!
+ * @brief 文字列に対応する節を返す
+ * @param pat 文字列
+ * @return 節. いずれのトリガーの先頭部分でもなければnullptr
  */
-int macro_find_check(concptr pat)
+const MacroTrieNode *macro_trie_find(concptr pat)
+{
+    auto node = 0;
+    for (auto s = pat; *s; s++) {
+        const auto &children = macro_trie[node].children;
+        const auto it = children.find(*s);
+        if (it == children.end()) {
+            return nullptr;
+        }
+
+        node = it->second;
+    }
+
+    return &macro_trie[node];
+}
+}
+
+/* Find the macro (if any) which exactly matches the given pattern */
+int macro_find_exact(concptr pat)
 {
     if (!macro_uses[(byte)(pat[0])]) {
         return -1;
     }
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(macro_patterns[i], pat)) {
-            continue;
-        }
+    const auto *node = macro_trie_find(pat);
+    return node ? node->exact : -1;
+}
 
-        return i;
+/*
+ * Find the first macro (if any) which contains the given pattern
+ */
+int macro_find_check(concptr pat)
+{
+    if (!macro_uses[(byte)(pat[0])]) {
+        return -1;
     }
 
-    return -1;
+    const auto *node = macro_trie_find(pat);
+    return node ? node->first : -1;
 }
 
 /*
@@ -65,18 +122,8 @@ int macro_find_maybe(concptr pat)
         return -1;
     }
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(macro_patterns[i], pat)) {
-            continue;
-        }
-        if (streq(macro_patterns[i], pat)) {
-            continue;
-        }
-
-        return i;
-    }
-
-    return -1;
+    const auto *node = macro_trie_find(pat);
+    return node ? node->first_longer : -1;
 }
 
 /*
@@ -84,24 +131,23 @@ int macro_find_maybe(concptr pat)
  */
 int macro_find_ready(concptr pat)
 {
-    int t, n = -1, s = -1;
-
     if (!macro_uses[(byte)(pat[0])]) {
         return -1;
     }
 
-    for (int i = 0; i < active_macros; ++i) {
-        if (!prefix(pat, macro_patterns[i])) {
-            continue;
+    auto n = -1;
+    auto node = 0;
+    for (auto s = pat; *s; s++) {
+        const auto &children = macro_trie[node].children;
+        const auto it = children.find(*s);
+        if (it == children.end()) {
+            break;
         }
 
-        t = macro_patterns[i].size();
-        if ((n >= 0) && (s > t)) {
-            continue;
+        node = it->second;
+        if (macro_trie[node].exact >= 0) {
+            n = macro_trie[node].exact;
         }
-
-        n = i;
-        s = t;
     }
 
     return n;
@@ -134,6 +180,7 @@ errr macro_add(concptr pat, concptr act)
     if (n < 0) {
         n = active_macros++;
         macro_patterns[n] = pat;
+        macro_trie_insert(pat, n);
     }
 
     macro_actions[n] = act;
@@ -179,7 +179,7 @@ void do_cmd_player_status(PlayerType *player_ptr)
  */
 void do_cmd_message_one(void)
 {
-    prt(format("> %s", message_str(0)->data()), 0, 0);
+    prt(format("> %s", message_str(0).data()), 0, 0);
 }
 
 /*!
@@ -198,7 +198,7 @@ static int calc_oldest_base_msg_num(int num_lines, int width)
 
     for (auto oldest_base_msg_num = message_num(); oldest_base_msg_num > 0; --oldest_base_msg_num) {
         const auto msg_str = message_str(oldest_base_msg_num - 1);
-        const auto lines = shape_buffer(*msg_str, width);
+        const auto lines = shape_buffer(msg_str, width);
         lines_count += std::ssize(lines);
         if (lines_count > num_lines) {
             return oldest_base_msg_num;
@@ -237,7 +237,7 @@ static int display_message_history(int base_msg_num, int num_now, int num_lines,
         const auto msg_str = message_str(msg_num);
         const auto color = (msg_num < num_now) ? TERM_WHITE : TERM_SLATE;
 
-        auto lines = shape_buffer(*msg_str, width);
+        auto lines = shape_buffer(msg_str, width);
         if (displayed_lines + std::ssize(lines) > num_lines) {
             break;
         }
@@ -351,13 +351,8 @@ void do_cmd_messages(int num_now)
             }
 
             shower = finder_str;
-            for (auto msg_num = base_msg_num + 1; msg_num < message_num(); msg_num++) {
-                // @details ダメ文字対策でstringを使わない.
-                const auto msg = message_str(msg_num);
-                if (str_find(*msg, finder_str)) {
-                    base_msg_num = msg_num;
-                    break;
-                }
+            if (const auto found_msg_num = message_search(base_msg_num + 1, finder_str); found_msg_num) {
+                base_msg_num = *found_msg_num;
             }
 
             break;
@@ -894,6 +894,7 @@ void exe_fire(PlayerType *player_ptr, INVENTORY_IDX i_idx, ItemEntity *j_ptr, SP
 
                                 m_ptr->fx = nx;
                                 m_ptr->fy = ny;
+                                floor.spatial_index.update_monster(m_idx, m_ptr->get_position());
 
                                 update_monster(player_ptr, m_idx, true);
 
@@ -0,0 +1,194 @@
+#include "core/high-score-store.h"
+#include "io/files-util.h"
+#include "system/angband.h"
+#include "util/angband-files.h"
+#include <algorithm>
+
+namespace {
+const std::vector<int> EMPTY_RANKS;
+
+std::filesystem::path get_score_file_path()
+{
+    return path_build(ANGBAND_DIR_APEX, "scores.raw");
+}
+
+/*!
+ * @brief スコアファイルの更新を排他するためのロックファイルを開く
+ * @return ファイルディスクリプタ. 開けなければ-1
+ * @details スコアファイル自体は置き換えるのでロックに使えない.
+ */
+int open_lock_file()
+{
+    const auto path = path_build(ANGBAND_DIR_APEX, "scores.lock");
+    const auto fd = fd_open(path, O_RDWR);
+    if (fd >= 0) {
+        return fd;
+    }
+
+    const auto made_fd = fd_make(path);
+    return (made_fd >= 0) ? made_fd : fd_open(path, O_RDWR);
+}
+}
+
+/*!
+ * @brief スコアファイルを読み込んで索引を作る
+ * @return スコアファイルの内容. 開けなければstd::nullopt
+ */
+std::optional<HighScoreStore> HighScoreStore::load()
+{
+    const auto fd = fd_open(get_score_file_path(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    HighScoreStore store;
+    const auto file_size = lseek(fd, 0, SEEK_END);
+    const auto num_scores = std::clamp<long>(file_size / static_cast<long>(sizeof(high_score)), 0, MAX_HISCORES);
+    store.scores.resize(num_scores);
+    const auto is_read = (fd_seek(fd, 0) == 0) && ((num_scores == 0) || (fd_read(fd, reinterpret_cast<char *>(store.scores.data()), num_scores * sizeof(high_score)) == 0));
+    (void)fd_close(fd);
+    if (!is_read) {
+        return std::nullopt;
+    }
+
+    std::stable_sort(store.scores.begin(), store.scores.end(), [](const high_score &a, const high_score &b) {
+        return std::atoi(a.pts) > std::atoi(b.pts);
+    });
+    store.build_indexes();
+    return store;
+}
+
+/*!
+ * @brief スコアファイルにスコアを追加する
+ * @param score 追加するスコア
+ * @return 追加した順位 (0が最上位). 失敗したら-1
+ * @details ロックを取った後に読み直すので、他のプレイヤーが直前に追加したスコアも失われない.
+ * 開いたままのスコアファイルはWindowsでは置き換えられないので、置き換える間だけhighscore_fdを閉じる.
+ */
+int HighScoreStore::add(const high_score &score)
+{
+    const auto lock_fd = open_lock_file();
+    if (lock_fd < 0) {
+        return -1;
+    }
+
+    if (fd_lock(lock_fd, F_WRLCK)) {
+        (void)fd_close(lock_fd);
+        return -1;
+    }
+
+    auto store = load();
+    auto rank = -1;
+    if (store) {
+        rank = store->find_rank(score);
+        store->insert(rank, score);
+        const auto is_score_file_open = highscore_fd >= 0;
+        if (is_score_file_open) {
+            (void)fd_close(highscore_fd);
+            highscore_fd = -1;
+        }
+
+        if (!store->save()) {
+            rank = -1;
+        }
+
+        if (is_score_file_open) {
+            highscore_fd = fd_open(get_score_file_path(), O_RDWR);
+        }
+    }
+
+    (void)fd_lock(lock_fd, F_UNLCK);
+    (void)fd_close(lock_fd);
+    return rank;
+}
+
+int HighScoreStore::size() const
+{
+    return static_cast<int>(this->scores.size());
+}
+
+/*!
+ * @brief 指定順位のスコアを返す
+ * @param rank 順位 (0が最上位)
+ */
+const high_score &HighScoreStore::get_score(int rank) const
+{
+    return this->scores.at(rank);
+}
+
+/*!
+ * @brief スコアが入る順位を返す
+ * @param score スコア
+ * @return 同点より下で最も高い順位. 一杯ならば最下位
+ */
+int HighScoreStore::find_rank(const high_score &score) const
+{
+    const auto my_points = std::atoi(score.pts);
+    const auto it = std::partition_point(this->points.begin(), this->points.end(), [my_points](int p) { return p >= my_points; });
+    return std::min(static_cast<int>(std::distance(this->points.begin(), it)), MAX_HISCORES - 1);
+}
+
+/*!
+ * @brief 種族毎の順位の一覧を返す
+ * @param race 種族ID
+ * @return 順位の昇順の一覧
+ */
+const std::vector<int> &HighScoreStore::get_ranks_by_race(int race) const
+{
+    const auto it = this->race_ranks.find(race);
+    return (it == this->race_ranks.end()) ? EMPTY_RANKS : it->second;
+}
+
+/*!
+ * @brief スコアを指定順位に挿入し、溢れた最下位を捨てる
+ */
+void HighScoreStore::insert(int rank, const high_score &score)
+{
+    this->scores.insert(this->scores.begin() + rank, score);
+    if (this->size() > MAX_HISCORES) {
+        this->scores.resize(MAX_HISCORES);
+    }
+
+    this->build_indexes();
+}
+
+void HighScoreStore::build_indexes()
+{
+    this->points.clear();
+    this->race_ranks.clear();
+    for (auto rank = 0; rank < this->size(); rank++) {
+        const auto &score = this->scores[rank];
+        this->points.push_back(std::atoi(score.pts));
+        this->race_ranks[std::atoi(score.p_r)].push_back(rank);
+    }
+}
+
+/*!
+ * @brief 一時ファイルに書き出してからスコアファイルを置き換える
+ * @return 置き換えられたか否か
+ * @details 一時ファイルの名前は固定なので、add() のロックの内側でのみ呼ぶこと.
+ */
+bool HighScoreStore::save() const
+{
+    const auto path = get_score_file_path();
+    const auto temp_path = path_build(ANGBAND_DIR_APEX, "scores.raw.tmp");
+    fd_kill(temp_path);
+    const auto fd = fd_make(temp_path);
+    if (fd < 0) {
+        return false;
+    }
+
+    const auto is_written = this->scores.empty() || (fd_write(fd, reinterpret_cast<const char *>(this->scores.data()), this->scores.size() * sizeof(high_score)) == 0);
+    (void)fd_close(fd);
+    if (!is_written) {
+        fd_kill(temp_path);
+        return false;
+    }
+
+    if (!fd_replace(temp_path, path)) {
+        fd_kill(temp_path);
+        return false;
+    }
+
+    return true;
+}
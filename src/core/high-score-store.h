@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/score-util.h"
+#include <map>
+#include <optional>
+#include <vector>
+
+/*!
+ * @brief スコアファイルの内容と、その順位・種族の索引
+ * @details
+ * スコアファイルは得点の降順に high_score を並べたもので、形式は従来と同じ.
+ * 読み込みは1度にまとめて行い、以後の順位の検索や種族毎の一覧はメモリ上の索引で引く.
+ * 追加は別ファイルの排他ロック (Windowsでは LockFileEx、その他では flock) を取ってから最新の内容を読み直し、一時ファイルに書いてから置き換える.
+ * このため、同じスコアファイルを複数のプレイヤーが同時に更新しても記録が失われず、読む側が書きかけのファイルを見ることもない.
+ */
+class HighScoreStore {
+public:
+    static std::optional<HighScoreStore> load();
+    static int add(const high_score &score);
+
+    int size() const;
+    const high_score &get_score(int rank) const;
+    int find_rank(const high_score &score) const;
+    const std::vector<int> &get_ranks_by_race(int race) const;
+
+private:
+    HighScoreStore() = default;
+
+    std::vector<high_score> scores; //!< 得点の降順に並んだスコア
+    std::vector<int> points; //!< 各スコアの得点
+    std::map<int, std::vector<int>> race_ranks; //!< 種族毎の順位の一覧
+
+    void insert(int rank, const high_score &score);
+    void build_indexes();
+    bool save() const;
+};
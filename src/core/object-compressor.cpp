@@ -30,6 +30,13 @@ static void compact_objects_aux(FloorType *floor_ptr, OBJECT_IDX i1, OBJECT_IDX
 
     // 要素番号i1のオブジェクトを要素番号i2に移動し、i1はクリアする
     floor_ptr->o_list[i2] = std::exchange(floor_ptr->o_list[i1], {});
+
+    // 床上のアイテムなら位置索引も付け替える
+    const auto &item = floor_ptr->o_list[i2];
+    floor_ptr->spatial_index.remove_item(i1);
+    if (!item.is_held_by_monster()) {
+        floor_ptr->spatial_index.update_item(i2, { item.iy, item.ix });
+    }
 }
 
 /*!
@@ -115,4 +122,6 @@ void compact_objects(PlayerType *player_ptr, int size)
         compact_objects_aux(floor_ptr, floor_ptr->o_max - 1, i);
         floor_ptr->o_max--;
     }
+
+    floor_ptr->clear_released_item_indices();
 }
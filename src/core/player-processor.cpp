@@ -61,6 +61,7 @@
 #include "view/display-messages.h"
 #include "window/display-sub-windows.h"
 #include "world/world-turn-processor.h"
+#include <algorithm>
 
 bool load = true;
 bool can_save = false;
@@ -457,3 +458,34 @@ void process_upkeep_with_speed(PlayerType *player_ptr)
         player_ptr->enchant_energy_need += ENERGY_NEED();
     }
 }
+
+/*!
+ * @brief プレイヤーの行動も持続効果の維持処理も起きないまま経過するゲームターン数を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return process_player() と process_upkeep_with_speed() が行動エネルギーを減らすだけで終わるゲームターン数
+ */
+int count_player_idle_turns(PlayerType *player_ptr)
+{
+    if (load || player_ptr->leaving || player_ptr->hack_mutation || player_ptr->invoking_midnight_curse) {
+        return 0;
+    }
+
+    if (AngbandSystem::get_instance().is_phase_out()) {
+        return 0;
+    }
+
+    const auto idle_turns = count_idle_game_turns(player_ptr->energy_need, player_ptr->pspeed);
+    return std::min(idle_turns, count_idle_game_turns(player_ptr->enchant_energy_need, player_ptr->pspeed));
+}
+
+/*!
+ * @brief 何も起きないゲームターンの分だけプレイヤーの行動エネルギーをまとめて減らす
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param turns count_player_idle_turns() 以下のゲームターン数
+ */
+void spend_player_idle_turns(PlayerType *player_ptr, int turns)
+{
+    const auto energy = speed_to_energy(player_ptr->pspeed) * turns;
+    player_ptr->energy_need -= static_cast<ENERGY>(energy);
+    player_ptr->enchant_energy_need -= static_cast<ENERGY>(energy);
+}
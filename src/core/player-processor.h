@@ -7,3 +7,5 @@ class PlayerType;
 bool continuous_action_running(PlayerType *player_ptr);
 void process_player(PlayerType *player_ptr);
 void process_upkeep_with_speed(PlayerType *player_ptr);
+int count_player_idle_turns(PlayerType *player_ptr);
+void spend_player_idle_turns(PlayerType *player_ptr, int turns);
@@ -39,6 +39,3 @@ struct high_score {
 };
 
 extern int highscore_fd;
-
-int highscore_seek(int i);
-errr highscore_read(high_score *score);
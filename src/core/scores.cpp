@@ -13,6 +13,7 @@
 #include "core/scores.h"
 #include "cmd-io/cmd-dump.h"
 #include "core/asking-player.h"
+#include "core/high-score-store.h"
 #include "core/score-util.h"
 #include "core/turn-compensator.h"
 #include "game-option/birth-options.h"
@@ -41,103 +42,6 @@
 #include "view/display-scores.h"
 #include "world/world.h"
 
-/*!
- * @brief 所定ポインタへスコア情報を書き込む / Write one score to the highscore file
- * @param score スコア情報参照ポインタ
- * @return エラーコード(問題がなければ0を返す)
- */
-static int highscore_write(high_score *score)
-{
-    /* Write the record, note failure */
-    return fd_write(highscore_fd, (char *)(score), sizeof(high_score));
-}
-
-/*!
- * @brief スコア情報を全て得るまで繰り返し取得する / Just determine where a new score *would* be placed
- * @param score スコア情報参照ポインタ
- * @return 正常ならば(MAX_HISCORES - 1)、問題があれば-1を返す
- */
-static int highscore_where(high_score *score)
-{
-    /* Paranoia -- it may not have opened */
-    if (highscore_fd < 0) {
-        return -1;
-    }
-
-    /* Go to the start of the highscore file */
-    if (highscore_seek(0)) {
-        return -1;
-    }
-
-    /* Read until we get to a higher score */
-    high_score the_score;
-    int my_score = atoi(score->pts);
-    for (int i = 0; i < MAX_HISCORES; i++) {
-        int old_score;
-        if (highscore_read(&the_score)) {
-            return i;
-        }
-        old_score = atoi(the_score.pts);
-        if (my_score > old_score) {
-            return i;
-        }
-    }
-
-    /* The "last" entry is always usable */
-    return MAX_HISCORES - 1;
-}
-
-/*!
- * @brief スコア情報をバッファの末尾に追加する / Actually place an entry into the high score file
- * @param score スコア情報参照ポインタ
- * @return 正常ならば書き込んだスロット位置、問題があれば-1を返す / Return the location (0 is best) or -1 on "failure"
- */
-static int highscore_add(high_score *score)
-{
-    /* Paranoia -- it may not have opened */
-    if (highscore_fd < 0) {
-        return -1;
-    }
-
-    /* Determine where the score should go */
-    int slot = highscore_where(score);
-
-    /* Hack -- Not on the list */
-    if (slot < 0) {
-        return -1;
-    }
-
-    /* Hack -- prepare to dump the new score */
-    high_score the_score = (*score);
-
-    /* Slide all the scores down one */
-    bool done = false;
-    high_score tmpscore;
-    for (int i = slot; !done && (i < MAX_HISCORES); i++) {
-        /* Read the old guy, note errors */
-        if (highscore_seek(i)) {
-            return -1;
-        }
-        if (highscore_read(&tmpscore)) {
-            done = true;
-        }
-
-        /* Back up and dump the score we were holding */
-        if (highscore_seek(i)) {
-            return -1;
-        }
-        if (highscore_write(&the_score)) {
-            return -1;
-        }
-
-        /* Hack -- Save the old score, for the next pass */
-        the_score = tmpscore;
-    }
-
-    /* Return location used */
-    return slot;
-}
-
 /*!
  * @brief スコアサーバへの転送処理
  * @param player_ptr プレイヤーへの参照ポインタ
@@ -216,17 +120,9 @@ errr top_twenty(PlayerType *player_ptr)
     }
 
     safe_setuid_grab();
-    auto err = fd_lock(highscore_fd, F_WRLCK);
-    safe_setuid_drop();
-    if (err) {
-        return 1;
-    }
-
-    auto j = highscore_add(&the_score);
-    safe_setuid_grab();
-    err = fd_lock(highscore_fd, F_UNLCK);
+    const auto j = HighScoreStore::add(the_score);
     safe_setuid_drop();
-    if (err) {
+    if (j < 0) {
         return 1;
     }
 
@@ -262,7 +158,8 @@ errr predict_score(PlayerType *player_ptr)
     angband_strcpy(the_score.day, _("今日", "TODAY"), sizeof(the_score.day));
     the_score.copy_info(*player_ptr);
     strcpy(the_score.how, _("yet", "nobody (yet!)"));
-    auto j = highscore_where(&the_score);
+    const auto store = HighScoreStore::load();
+    const auto j = store ? store->find_rank(the_score) : -1;
     if (j < 10) {
         display_scores(0, 15, j, &the_score);
         return 0;
@@ -280,39 +177,20 @@ errr predict_score(PlayerType *player_ptr)
 void show_highclass(PlayerType *player_ptr)
 {
     screen_save();
-    const auto path = path_build(ANGBAND_DIR_APEX, "scores.raw");
-    highscore_fd = fd_open(path, O_RDONLY);
-    if (highscore_fd < 0) {
+    const auto store = HighScoreStore::load();
+    if (!store) {
         msg_print(_("スコア・ファイルが使用できません。", "Score file unavailable."));
         msg_print(nullptr);
+        screen_load();
         return;
     }
 
-    if (highscore_seek(0)) {
-        return;
-    }
-
-    high_score the_score;
-    for (int i = 0; i < MAX_HISCORES; i++) {
-        if (highscore_read(&the_score)) {
-            break;
-        }
-    }
-
     int m = 0;
-    int j = 0;
-    PLAYER_LEVEL clev = 0;
-    int pr;
     char out_val[256];
-    while ((m < 9) && (j < MAX_HISCORES)) {
-        if (highscore_seek(j)) {
-            break;
-        }
-        if (highscore_read(&the_score)) {
-            break;
-        }
-        pr = atoi(the_score.p_r);
-        clev = (PLAYER_LEVEL)atoi(the_score.cur_lev);
+    for (; (m < 9) && (m < store->size()); m++) {
+        const auto &the_score = store->get_score(m);
+        const auto pr = std::atoi(the_score.p_r);
+        const auto clev = std::atoi(the_score.cur_lev);
 
 #ifdef JP
         snprintf(out_val, sizeof(out_val), "   %3d) %sの%s (レベル %2d)", (m + 1), race_info[pr].title.data(), the_score.who, clev);
@@ -321,8 +199,6 @@ void show_highclass(PlayerType *player_ptr)
 #endif
 
         prt(out_val, (m + 7), 0);
-        m++;
-        j++;
     }
 
 #ifdef JP
@@ -332,14 +208,11 @@ void show_highclass(PlayerType *player_ptr)
 #endif
 
     prt(out_val, (m + 8), 0);
-
-    (void)fd_close(highscore_fd);
-    highscore_fd = -1;
     prt(_("何かキーを押すとゲームに戻ります", "Hit any key to continue"), 0, 0);
 
     (void)inkey();
 
-    for (j = 5; j < 18; j++) {
+    for (auto j = 5; j < 18; j++) {
         prt("", j, 0);
     }
     screen_load();
@@ -352,57 +225,30 @@ void show_highclass(PlayerType *player_ptr)
  */
 void race_score(PlayerType *player_ptr, int race_num)
 {
-    int i = 0, j, m = 0;
-    int pr, clev;
-    high_score the_score;
-    auto lastlev = 0;
-
     /* rr9: TODO - pluralize the race */
     prt(std::string(_("最高の", "The Greatest of all the ")).append(race_info[race_num].title), 5, 15);
-    const auto path = path_build(ANGBAND_DIR_APEX, "scores.raw");
-    highscore_fd = fd_open(path, O_RDONLY);
-    if (highscore_fd < 0) {
+    const auto store = HighScoreStore::load();
+    if (!store) {
         msg_print(_("スコア・ファイルが使用できません。", "Score file unavailable."));
         msg_print(nullptr);
         return;
     }
 
-    if (highscore_seek(0)) {
-        return;
-    }
-
-    for (i = 0; i < MAX_HISCORES; i++) {
-        if (highscore_read(&the_score)) {
-            break;
-        }
-    }
-
-    m = 0;
-    j = 0;
-
-    while ((m < 10) || (j < MAX_HISCORES)) {
-        if (highscore_seek(j)) {
-            break;
-        }
-        if (highscore_read(&the_score)) {
-            break;
-        }
-        pr = atoi(the_score.p_r);
-        clev = atoi(the_score.cur_lev);
-
-        if (pr == race_num) {
-            char out_val[256];
+    auto m = 0;
+    auto lastlev = 0;
+    for (const auto rank : store->get_ranks_by_race(race_num)) {
+        const auto &the_score = store->get_score(rank);
+        const auto clev = std::atoi(the_score.cur_lev);
+        char out_val[256];
 #ifdef JP
-            snprintf(out_val, sizeof(out_val), "   %3d) %sの%s (レベル %2d)", (m + 1), race_info[pr].title.data(), the_score.who, clev);
+        snprintf(out_val, sizeof(out_val), "   %3d) %sの%s (レベル %2d)", (m + 1), race_info[race_num].title.data(), the_score.who, clev);
 #else
-            snprintf(out_val, sizeof(out_val), "%3d) %s the %s (Level %3d)", (m + 1), the_score.who, race_info[pr].title.data(), clev);
+        snprintf(out_val, sizeof(out_val), "%3d) %s the %s (Level %3d)", (m + 1), the_score.who, race_info[race_num].title.data(), clev);
 #endif
 
-            prt(out_val, (m + 7), 0);
-            m++;
-            lastlev = clev;
-        }
-        j++;
+        prt(out_val, (m + 7), 0);
+        m++;
+        lastlev = clev;
     }
 
     /* add player if qualified */
@@ -416,9 +262,6 @@ void race_score(PlayerType *player_ptr, int race_num)
 
         prt(out_val, (m + 8), 0);
     }
-
-    (void)fd_close(highscore_fd);
-    highscore_fd = -1;
 }
 
 /*!
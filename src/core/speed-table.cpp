@@ -58,3 +58,18 @@ byte speed_to_energy(byte speed)
 {
     return speed > 199 ? 49 : extract_energy[speed];
 }
+
+/*!
+ * @brief 行動エネルギーが溜まり切らないまま経過するゲームターン数を返す
+ * @param energy_need 次の行動までに必要な行動エネルギー
+ * @param speed 加速値
+ * @return 1ゲームターン毎に speed_to_energy(speed) ずつ減らしても energy_need が正のままであるターン数
+ */
+int count_idle_game_turns(int energy_need, byte speed)
+{
+    if (energy_need <= 0) {
+        return 0;
+    }
+
+    return (energy_need - 1) / speed_to_energy(speed);
+}
@@ -6,3 +6,4 @@
 #define ENERGY_NEED() (randnor(100, 25))
 
 byte speed_to_energy(byte speed);
+int count_idle_game_turns(int energy_need, byte speed);
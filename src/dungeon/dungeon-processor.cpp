@@ -7,6 +7,7 @@
 #include "core/turn-compensator.h"
 #include "core/window-redrawer.h"
 #include "dungeon/quest.h"
+#include "floor/floor-events.h"
 #include "floor/floor-leaver.h"
 #include "floor/floor-save-util.h"
 #include "floor/floor-save.h"
@@ -42,6 +43,7 @@
 #include "view/display-messages.h"
 #include "world/world-turn-processor.h"
 #include "world/world.h"
+#include <algorithm>
 
 static void redraw_character_xtra(PlayerType *player_ptr)
 {
@@ -84,6 +86,70 @@ static void redraw_character_xtra(PlayerType *player_ptr)
     world.character_xtra = false;
 }
 
+/*!
+ * @brief ゲームターンを1つ進める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ */
+static void advance_game_turn(PlayerType *player_ptr)
+{
+    auto &world = AngbandWorld::get_instance();
+    world.game_turn++;
+    const auto is_wild_mode = world.is_wild_mode();
+    if (world.dungeon_turn < world.dungeon_turn_limit) {
+        if (!is_wild_mode || wild_regen) {
+            world.dungeon_turn++;
+        } else if (is_wild_mode && !(world.game_turn % ((MAX_HGT + MAX_WID) / 2))) {
+            world.dungeon_turn++;
+        }
+    }
+
+    prevent_turn_overflow(player_ptr);
+}
+
+/*!
+ * @brief 何も起きないゲームターンをまとめて進める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * 世界の時間経過処理 (TURNS_PER_TICK 毎)・ダンジョンの雰囲気の更新・プレイヤーとモンスターの行動・持続効果の維持の
+ * いずれも起きないゲームターンは、行動エネルギーが減ってターン数が進むだけである.
+ * そこで次にいずれかが起きるゲームターンの直前まで、それだけを一度に行う.
+ * 飛ばしたゲームターンでは乱数も消費しないので、1ターンずつ処理した時と結果は変わらない.
+ */
+static void skip_idle_game_turns(PlayerType *player_ptr)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    if (floor.inside_arena || AngbandSystem::get_instance().is_phase_out()) {
+        return;
+    }
+
+    const auto &world = AngbandWorld::get_instance();
+    auto idle_turns = static_cast<int>((TURNS_PER_TICK - world.game_turn % TURNS_PER_TICK) % TURNS_PER_TICK);
+    const auto feeling_turn = get_next_dungeon_feeling_turn(player_ptr);
+    if (feeling_turn) {
+        const auto turns_to_feeling = std::max<int64_t>(*feeling_turn - static_cast<int64_t>(world.game_turn), 0);
+        idle_turns = static_cast<int>(std::min<int64_t>(idle_turns, cheat_xtra ? 0 : turns_to_feeling));
+    }
+
+    idle_turns = std::min(idle_turns, count_player_idle_turns(player_ptr));
+    if (idle_turns <= 0) {
+        return;
+    }
+
+    idle_turns = count_monster_idle_turns(player_ptr, idle_turns);
+    if (idle_turns <= 0) {
+        return;
+    }
+
+    spend_player_idle_turns(player_ptr, idle_turns);
+    spend_monster_idle_turns(player_ptr, idle_turns);
+    for (auto i = 0; i < idle_turns; i++) {
+        advance_game_turn(player_ptr);
+        if (wild_regen) {
+            wild_regen--;
+        }
+    }
+}
+
 /*!
  * process_player()、process_world() をcore.c から移設するのが先.
  * process_upkeep_with_speed() はこの関数と同じところでOK
@@ -213,6 +279,8 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
 
     player_ptr->leaving_dungeon = false;
     floor.reset_mproc();
+    floor.reset_spatial_index();
+    floor.reset_monster_turn_states();
 
     while (true) {
         if ((floor.m_cnt + 32 > MAX_FLOOR_MONSTERS) && !is_watching) {
@@ -268,18 +336,7 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
             break;
         }
 
-        world.game_turn++;
-        const auto is_wild_mode = world.is_wild_mode();
-        if (world.dungeon_turn < world.dungeon_turn_limit) {
-            if (!is_wild_mode || wild_regen) {
-                world.dungeon_turn++;
-            } else if (is_wild_mode && !(world.game_turn % ((MAX_HGT + MAX_WID) / 2))) {
-                world.dungeon_turn++;
-            }
-        }
-
-        prevent_turn_overflow(player_ptr);
-
+        advance_game_turn(player_ptr);
         if (player_ptr->leaving) {
             break;
         }
@@ -287,6 +344,8 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
         if (wild_regen) {
             wild_regen--;
         }
+
+        skip_idle_game_turns(player_ptr);
     }
 
     if ((inside_quest(quest_id)) && monrace_questor.kind_flags.has_not(MonsterKindType::UNIQUE)) {
@@ -132,9 +132,9 @@ ProjectResult project(PlayerType *player_ptr, const MONSTER_IDX src_idx, POSITIO
         break;
     }
 
-    /* Calculate the projection path */
+    /* Calculate the projection path (辿る途中で地形が変わりキャッシュが破棄されうるのでコピーする) */
     const auto &system = AngbandSystem::get_instance();
-    ProjectionPath path_g(player_ptr, (project_length ? project_length : system.get_max_range()), { y1, x1 }, { y2, x2 }, flag);
+    const auto path_g = ProjectionPathCache::get_instance().get(player_ptr, (project_length ? project_length : system.get_max_range()), { y1, x1 }, { y2, x2 }, flag);
     handle_stuff(player_ptr);
 
     int k = 0;
@@ -384,11 +384,7 @@ static void decide_grid_glowing(FloorType *floor_ptr, DungeonData *dd_ptr, Dunge
         return;
     }
 
-    for (POSITION y = 0; y < floor_ptr->height; y++) {
-        for (POSITION x = 0; x < floor_ptr->width; x++) {
-            floor_ptr->grid_array[y][x].info |= CAVE_GLOW;
-        }
-    }
+    floor_ptr->update_grid_info(floor_ptr->get_area(), 0, CAVE_GLOW);
 }
 
 /*!
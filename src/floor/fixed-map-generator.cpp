@@ -71,6 +71,7 @@ static void drop_here(FloorType &floor, ItemEntity &&item, POSITION y, POSITION
     dropped_item.held_m_idx = 0;
     auto *g_ptr = &floor.grid_array[y][x];
     g_ptr->o_idx_list.add(&floor, item_idx);
+    floor.spatial_index.update_item(item_idx, { y, x });
 }
 
 static void generate_artifact(PlayerType *player_ptr, qtwg_type *qtwg_ptr, const FixedArtifactId a_idx)
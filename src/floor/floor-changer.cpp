@@ -30,6 +30,7 @@
 #include "monster/monster-update.h"
 #include "player-base/player-class.h"
 #include "spell-kind/spells-floor.h"
+#include "store/store.h"
 #include "system/artifact-type-definition.h"
 #include "system/dungeon/dungeon-definition.h"
 #include "system/enums/dungeon/dungeon-id.h"
@@ -42,6 +43,7 @@
 #include "system/player-type-definition.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "target/projection-path-calculator.h"
 #include "timed-effect/timed-effects.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
@@ -118,6 +120,8 @@ static MonraceDefinition &set_pet_params(PlayerType *player_ptr, const int curre
     *m_ptr = party_mon[current_monster].clone();
     m_ptr->fy = cy;
     m_ptr->fx = cx;
+    player_ptr->current_floor_ptr->spatial_index.update_monster(m_idx, m_ptr->get_position());
+    player_ptr->current_floor_ptr->monster_turn_states.update(m_idx, *m_ptr);
     m_ptr->current_floor_ptr = player_ptr->current_floor_ptr;
     m_ptr->ml = true;
     m_ptr->mtimed[MonsterTimedEffect::SLEEP] = 0;
@@ -455,6 +459,7 @@ void change_floor(PlayerType *player_ptr)
     update_unique_artifact(*player_ptr->current_floor_ptr, new_floor_id);
     player_ptr->floor_id = new_floor_id;
     world.character_dungeon = true;
+    ProjectionPathCache::get_instance().invalidate();
     if (player_ptr->ppersonality == PERSONALITY_MUNCHKIN) {
         wiz_lite(player_ptr, PlayerClass(player_ptr).equals(PlayerClassType::NINJA));
     }
@@ -462,6 +467,10 @@ void change_floor(PlayerType *player_ptr)
     player_ptr->current_floor_ptr->generated_turn = world.game_turn;
     player_ptr->feeling_turn = player_ptr->current_floor_ptr->generated_turn;
     player_ptr->feeling = 0;
+    if (!player_ptr->current_floor_ptr->is_underground()) {
+        prepare_store_stock_tables();
+    }
+
     auto &fcms = FloorChangeModesStore::get_instace();
     fcms->clear();
     select_floor_music(player_ptr);
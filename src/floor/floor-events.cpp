@@ -39,6 +39,7 @@
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <utility>
 
 static void update_sun_light(PlayerType *player_ptr)
 {
@@ -272,26 +273,43 @@ static byte get_dungeon_feeling(PlayerType *player_ptr)
 }
 
 /*!
- * @brief ダンジョンの雰囲気を更新し、変化があった場合メッセージを表示する
- * / Update dungeon feeling, and announce it if changed
+ * @brief 次にダンジョンの雰囲気を更新するゲームターンを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 更新するゲームターン. 雰囲気を感じない場所ならstd::nullopt
+ * @details cheat_xtra が有効な時は、このターンを待たずに毎ゲームターン更新する.
  */
-void update_dungeon_feeling(PlayerType *player_ptr)
+std::optional<int> get_next_dungeon_feeling_turn(const PlayerType *player_ptr)
 {
     const auto &floor = *player_ptr->current_floor_ptr;
     if (!floor.is_underground()) {
-        return;
+        return std::nullopt;
     }
 
     if (AngbandSystem::get_instance().is_phase_out()) {
-        return;
+        return std::nullopt;
     }
 
     const auto delay = std::max(10, 150 - player_ptr->skill_fos) * (150 - floor.dun_level) * TURNS_PER_TICK / 100;
+    return static_cast<int>(player_ptr->feeling_turn + delay);
+}
+
+/*!
+ * @brief ダンジョンの雰囲気を更新し、変化があった場合メッセージを表示する
+ * / Update dungeon feeling, and announce it if changed
+ */
+void update_dungeon_feeling(PlayerType *player_ptr)
+{
+    const auto feeling_turn = get_next_dungeon_feeling_turn(player_ptr);
+    if (!feeling_turn) {
+        return;
+    }
+
     const auto &world = AngbandWorld::get_instance();
-    if (world.game_turn < player_ptr->feeling_turn + delay && !cheat_xtra) {
+    if (std::cmp_less(world.game_turn, *feeling_turn) && !cheat_xtra) {
         return;
     }
 
+    const auto &floor = *player_ptr->current_floor_ptr;
     const auto quest_id = floor.get_quest_id();
     const auto &quests = QuestList::get_instance();
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <optional>
+
 class PlayerType;
 class FloorType;
 void day_break(PlayerType *player_ptr);
 void night_falls(PlayerType *player_ptr);
+std::optional<int> get_next_dungeon_feeling_turn(const PlayerType *player_ptr);
 void update_dungeon_feeling(PlayerType *player_ptr);
 void glow_deep_lava_and_bldg(PlayerType *player_ptr);
 void forget_lite(FloorType *floor_ptr);
@@ -49,6 +49,7 @@
 #include "system/player-type-definition.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "window/main-window-util.h"
@@ -351,18 +352,10 @@ static std::optional<std::string> level_gen(PlayerType *player_ptr)
  */
 void wipe_generate_random_floor_flags(FloorType *floor_ptr)
 {
-    for (auto y = 0; y < floor_ptr->height; y++) {
-        for (auto x = 0; x < floor_ptr->width; x++) {
-            floor_ptr->get_grid({ y, x }).info &= ~(CAVE_MASK);
-        }
-    }
-
+    const auto area = floor_ptr->get_area();
+    floor_ptr->update_grid_info(area, CAVE_MASK);
     if (floor_ptr->is_underground()) {
-        for (auto y = 1; y < floor_ptr->height - 1; y++) {
-            for (auto x = 1; x < floor_ptr->width - 1; x++) {
-                floor_ptr->get_grid({ y, x }).info |= CAVE_UNSAFE;
-            }
-        }
+        floor_ptr->update_grid_info(area.resized(-1), 0, CAVE_UNSAFE);
     }
 }
 
@@ -379,12 +372,17 @@ void clear_cave(PlayerType *player_ptr)
 
     floor.o_max = 1;
     floor.o_cnt = 0;
+    floor.clear_released_item_indices();
     MonraceList::get_instance().reset_current_numbers();
     for (auto &monster : floor.m_list) {
         monster.wipe();
     }
     floor.m_max = 1;
     floor.m_cnt = 0;
+    floor.clear_released_monster_indices();
+    floor.spatial_index.reset(MAX_HGT, MAX_WID);
+    floor.monster_turn_states.reset();
+    ProjectionPathCache::get_instance().invalidate();
     for (const auto mte : MONSTER_TIMED_EFFECT_RANGE) {
         floor.mproc_max[mte] = 0;
     }
@@ -249,6 +249,7 @@ static void get_out_monster(PlayerType *player_ptr)
         grid_neighbor.m_idx = m_idx;
         monster.fy = ny;
         monster.fx = nx;
+        floor.spatial_index.update_monster(m_idx, monster.get_position());
         return;
     }
 }
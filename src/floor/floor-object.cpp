@@ -156,6 +156,8 @@ void delete_all_items_from_floor(PlayerType *player_ptr, POSITION y, POSITION x)
         o_ptr = &floor_ptr->o_list[this_o_idx];
         o_ptr->wipe();
         floor_ptr->o_cnt--;
+        floor_ptr->release_item_index(this_o_idx);
+        floor_ptr->spatial_index.remove_item(this_o_idx);
     }
 
     g_ptr->o_idx_list.clear();
@@ -237,6 +239,7 @@ void delete_object_idx(PlayerType *player_ptr, OBJECT_IDX o_idx)
 
     j_ptr->wipe();
     floor_ptr->o_cnt--;
+    floor_ptr->release_item_index(o_idx);
     static constexpr auto flags = {
         SubWindowRedrawingFlag::FLOOR_ITEMS,
         SubWindowRedrawingFlag::FOUND_ITEMS,
@@ -253,6 +256,7 @@ void excise_object_idx(FloorType *floor_ptr, OBJECT_IDX o_idx)
 {
     auto &list = get_o_idx_list_contains(floor_ptr, o_idx);
     list.remove(o_idx);
+    floor_ptr->spatial_index.remove_item(o_idx);
 }
 
 /*!
@@ -506,6 +510,7 @@ OBJECT_IDX drop_near(PlayerType *player_ptr, ItemEntity *j_ptr, PERCENTAGE chanc
         j_ptr->ix = bx;
         j_ptr->held_m_idx = 0;
         g_ptr->o_idx_list.add(&floor, item_idx);
+        floor.spatial_index.update_item(item_idx, { by, bx });
         done = true;
     }
 
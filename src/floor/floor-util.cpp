@@ -142,6 +142,7 @@ void wipe_o_list(FloorType *floor_ptr)
 
     floor_ptr->o_max = 1;
     floor_ptr->o_cnt = 0;
+    floor_ptr->clear_released_item_indices();
 }
 
 /*
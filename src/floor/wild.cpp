@@ -14,6 +14,7 @@
 #include "dungeon/dungeon-flag-types.h"
 #include "dungeon/quest.h"
 #include "floor/cave.h"
+#include "floor/wilderness-height-map.h"
 #include "game-option/birth-options.h"
 #include "game-option/map-screen-options.h"
 #include "grid/feature.h"
@@ -35,7 +36,6 @@
 #include "player/player-status.h"
 #include "spell-realm/spells-hex.h"
 #include "status/action-setter.h"
-#include "system/angband-system.h"
 #include "system/dungeon/dungeon-definition.h"
 #include "system/dungeon/dungeon-list.h"
 #include "system/enums/dungeon/dungeon-id.h"
@@ -49,12 +49,13 @@
 #include "system/system-variables.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "term/z-rand.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "window/main-window-util.h"
 #include "world/world.h"
 
-constexpr auto MAX_FEAT_IN_TERRAIN = 18;
+constexpr auto MAX_FEAT_IN_TERRAIN = WILDERNESS_HEIGHT_LEVELS;
 
 std::vector<std::vector<wilderness_type>> wilderness;
 
@@ -140,112 +141,6 @@ void set_floor_and_wall(DungeonId dungeon_id)
     feat_wall_solid = dungeon.outer_wall;
 }
 
-/*!
- * @brief プラズマフラクタル的地形生成の再帰中間処理
- * / Helper for plasma generation.
- * @param x1 左上端の深み
- * @param x2 右上端の深み
- * @param x3 左下端の深み
- * @param x4 右下端の深み
- * @param xmid 中央座標X
- * @param ymid 中央座標Y
- * @param rough ランダム幅
- * @param depth_max 深みの最大値
- */
-static void perturb_point_mid(
-    FloorType &floor, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, FEAT_IDX x4, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
-{
-    FEAT_IDX tmp2 = rough * 2 + 1;
-    FEAT_IDX tmp = randint1(tmp2) - (rough + 1);
-    FEAT_IDX avg = ((x1 + x2 + x3 + x4) / 4) + tmp;
-    if (((x1 + x2 + x3 + x4) % 4) > 1) {
-        avg++;
-    }
-
-    if (avg < 0) {
-        avg = 0;
-    }
-
-    if (avg > depth_max) {
-        avg = depth_max;
-    }
-
-    floor.get_grid({ ymid, xmid }).feat = avg;
-}
-
-/*!
- * @brief プラズマフラクタル的地形生成の再帰末端処理
- * / Helper for plasma generation.
- * @param x1 中間末端部1の重み
- * @param x2 中間末端部2の重み
- * @param x3 中間末端部3の重み
- * @param xmid 最終末端部座標X
- * @param ymid 最終末端部座標Y
- * @param rough ランダム幅
- * @param depth_max 深みの最大値
- */
-static void perturb_point_end(FloorType &floor, FEAT_IDX x1, FEAT_IDX x2, FEAT_IDX x3, POSITION xmid, POSITION ymid, FEAT_IDX rough, FEAT_IDX depth_max)
-{
-    FEAT_IDX tmp2 = rough * 2 + 1;
-    FEAT_IDX tmp = randint0(tmp2) - rough;
-    FEAT_IDX avg = ((x1 + x2 + x3) / 3) + tmp;
-    if ((x1 + x2 + x3) % 3) {
-        avg++;
-    }
-
-    if (avg < 0) {
-        avg = 0;
-    }
-
-    if (avg > depth_max) {
-        avg = depth_max;
-    }
-
-    floor.get_grid({ ymid, xmid }).feat = avg;
-}
-
-/*!
- * @brief プラズマフラクタル的地形生成の開始処理
- * / Helper for plasma generation.
- * @param x1 処理範囲の左上X座標
- * @param y1 処理範囲の左上Y座標
- * @param x2 処理範囲の右下X座標
- * @param y2 処理範囲の右下Y座標
- * @param depth_max 深みの最大値
- * @param rough ランダム幅
- * @details
- * <pre>
- * A generic function to generate the plasma fractal.
- * Note that it uses ``cave_feat'' as temporary storage.
- * The values in ``cave_feat'' after this function
- * are NOT actual features; They are raw heights which
- * need to be converted to features.
- * </pre>
- */
-static void plasma_recursive(FloorType &floor, POSITION x1, POSITION y1, POSITION x2, POSITION y2, FEAT_IDX depth_max, FEAT_IDX rough)
-{
-    POSITION xmid = (x2 - x1) / 2 + x1;
-    POSITION ymid = (y2 - y1) / 2 + y1;
-    if (x1 + 1 == x2) {
-        return;
-    }
-
-    perturb_point_mid(floor, floor.get_grid({ y1, x1 }).feat, floor.get_grid({ y2, x1 }).feat, floor.get_grid({ y1, x2 }).feat,
-        floor.get_grid({ y2, x2 }).feat, xmid, ymid, rough, depth_max);
-    perturb_point_end(
-        floor, floor.get_grid({ y1, x1 }).feat, floor.get_grid({ y1, x2 }).feat, floor.get_grid({ ymid, xmid }).feat, xmid, y1, rough, depth_max);
-    perturb_point_end(
-        floor, floor.get_grid({ y1, x2 }).feat, floor.get_grid({ y2, x2 }).feat, floor.get_grid({ ymid, xmid }).feat, x2, ymid, rough, depth_max);
-    perturb_point_end(
-        floor, floor.get_grid({ y2, x2 }).feat, floor.get_grid({ y2, x1 }).feat, floor.get_grid({ ymid, xmid }).feat, xmid, y2, rough, depth_max);
-    perturb_point_end(
-        floor, floor.get_grid({ y2, x1 }).feat, floor.get_grid({ y1, x1 }).feat, floor.get_grid({ ymid, xmid }).feat, x1, ymid, rough, depth_max);
-    plasma_recursive(floor, x1, y1, xmid, ymid, depth_max, rough);
-    plasma_recursive(floor, xmid, y1, x2, ymid, depth_max, rough);
-    plasma_recursive(floor, x1, ymid, xmid, y2, depth_max, rough);
-    plasma_recursive(floor, xmid, ymid, x2, y2, depth_max, rough);
-}
-
 /*!
  * @brief 荒野フロア生成のサブルーチン
  * @param terrain 荒野地形ID
@@ -265,49 +160,25 @@ static void generate_wilderness_area(FloorType &floor, int terrain, uint32_t see
         return;
     }
 
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar wilderness_rng(seed);
-    system.set_rng(wilderness_rng);
-    int table_size = sizeof(terrain_table[0]) / sizeof(int16_t);
     if (!corner) {
+        const auto &height_map = WildernessHeightMapCache::get_instance().get(seed);
         for (auto y = 0; y < MAX_HGT; y++) {
             for (auto x = 0; x < MAX_WID; x++) {
-                floor.get_grid({ y, x }).feat = table_size / 2;
+                const auto is_inner = (y > 0) && (y < MAX_HGT - 1) && (x > 0) && (x < MAX_WID - 1);
+                const auto height = height_map[y][x];
+                floor.get_grid({ y, x }).feat = is_inner ? terrain_table[terrain][height] : height;
             }
         }
-    }
 
-    floor.get_grid({ 1, 1 }).feat = randnum0<short>(table_size);
-    floor.get_grid({ MAX_HGT - 2, 1 }).feat = randnum0<short>(table_size);
-    floor.get_grid({ 1, MAX_WID - 2 }).feat = randnum0<short>(table_size);
-    floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat = randnum0<short>(table_size);
-    if (corner) {
-        floor.get_grid({ 1, 1 }).feat = terrain_table[terrain][floor.get_grid({ 1, 1 }).feat];
-        floor.get_grid({ MAX_HGT - 2, 1 }).feat = terrain_table[terrain][floor.get_grid({ MAX_HGT - 2, 1 }).feat];
-        floor.get_grid({ 1, MAX_WID - 2 }).feat = terrain_table[terrain][floor.get_grid({ 1, MAX_WID - 2 }).feat];
-        floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat = terrain_table[terrain][floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat];
-        system.set_rng(rng_backup);
         return;
     }
 
-    const auto top_left = floor.get_grid({ 1, 1 }).feat;
-    const auto bottom_left = floor.get_grid({ MAX_HGT - 2, 1 }).feat;
-    const auto top_right = floor.get_grid({ 1, MAX_WID - 2 }).feat;
-    const auto bottom_right = floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat;
-    const short roughness = 1; /* The roughness of the level. */
-    plasma_recursive(floor, 1, 1, MAX_WID - 2, MAX_HGT - 2, table_size - 1, roughness);
-    floor.get_grid({ 1, 1 }).feat = top_left;
-    floor.get_grid({ MAX_HGT - 2, 1 }).feat = bottom_left;
-    floor.get_grid({ 1, MAX_WID - 2 }).feat = top_right;
-    floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat = bottom_right;
-    for (POSITION y1 = 1; y1 < MAX_HGT - 1; y1++) {
-        for (POSITION x1 = 1; x1 < MAX_WID - 1; x1++) {
-            floor.get_grid({ y1, x1 }).feat = terrain_table[terrain][floor.get_grid({ y1, x1 }).feat];
-        }
-    }
-
-    system.set_rng(rng_backup);
+    const RngStreamScope rng_scope(seed);
+    int table_size = sizeof(terrain_table[0]) / sizeof(int16_t);
+    floor.get_grid({ 1, 1 }).feat = terrain_table[terrain][randnum0<short>(table_size)];
+    floor.get_grid({ MAX_HGT - 2, 1 }).feat = terrain_table[terrain][randnum0<short>(table_size)];
+    floor.get_grid({ 1, MAX_WID - 2 }).feat = terrain_table[terrain][randnum0<short>(table_size)];
+    floor.get_grid({ MAX_HGT - 2, MAX_WID - 2 }).feat = terrain_table[terrain][randnum0<short>(table_size)];
 }
 
 /*!
@@ -392,14 +263,30 @@ static void generate_area(PlayerType *player_ptr, const Pos2D &pos, bool is_bord
         return;
     }
 
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar wilderness_rng(wilderness_grid.seed);
-    system.set_rng(wilderness_rng);
+    const RngStreamScope rng_scope(wilderness_grid.seed);
     const Pos2D pos_entrance(rand_range(6, floor.height - 6), rand_range(6, floor.width - 6));
     floor.get_grid(pos_entrance).feat = feat_entrance;
     floor.get_grid(pos_entrance).special = static_cast<short>(wilderness_grid.entrance);
-    system.set_rng(rng_backup);
+}
+
+/*!
+ * @brief 中央区画と上下左右の区画で使う高さマップを並列に生成しておく
+ * @param pos_center 中央区画の広域座標
+ * @details 角の区画は四隅の高さしか使わないので対象外.
+ */
+static void prefetch_wilderness_height_maps(const Pos2D &pos_center)
+{
+    static const std::array<Pos2DVec, 5> offsets = { { { 0, 0 }, { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } } };
+    std::vector<uint32_t> seeds;
+    for (const auto &offset : offsets) {
+        const auto pos = pos_center + offset;
+        const auto &wilderness_grid = wilderness[pos.y][pos.x];
+        if ((wilderness_grid.town == 0) && (wilderness_grid.terrain != TERRAIN_EDGE)) {
+            seeds.push_back(wilderness_grid.seed);
+        }
+    }
+
+    WildernessHeightMapCache::get_instance().prefetch(seeds);
 }
 
 /*!
@@ -442,6 +329,7 @@ void wilderness_gen(PlayerType *player_ptr)
     const auto wild_y = player_ptr->wilderness_y;
     const auto wild_x = player_ptr->wilderness_x;
     get_mon_num_prep(player_ptr, get_monster_hook(player_ptr));
+    prefetch_wilderness_height_maps({ wild_y, wild_x });
 
     /* North border */
     generate_area(player_ptr, { wild_y - 1, wild_x }, true, false);
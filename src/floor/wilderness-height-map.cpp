@@ -0,0 +1,204 @@
+/*!
+ * @brief 荒野の高さマップ生成とキャッシュ
+ * @details
+ * 高さマップはシード値で初期化した乱数ストリームをスレッド毎に束縛して生成するので、
+ * 複数の区画を並列に生成してもゲーム本体の乱数列とは競合しない.
+ */
+
+#include "floor/wilderness-height-map.h"
+#include "term/z-rand.h"
+#include <algorithm>
+#include <future>
+#include <vector>
+
+namespace {
+/*!
+ * @brief 1区画分の高さマップをプラズマフラクタルで生成するクラス
+ */
+class WildernessHeightMapGenerator {
+public:
+    explicit WildernessHeightMapGenerator(WildernessHeightMap &height_map)
+        : height_map(height_map)
+    {
+    }
+
+    void generate();
+
+private:
+    static constexpr short DEPTH_MAX = WILDERNESS_HEIGHT_LEVELS - 1;
+    static constexpr short ROUGHNESS = 1; /* The roughness of the level. */
+
+    WildernessHeightMap &height_map;
+
+    void perturb_point_mid(short x1, short x2, short x3, short x4, int xmid, int ymid);
+    void perturb_point_end(short x1, short x2, short x3, int xmid, int ymid);
+    void plasma_recursive(int x1, int y1, int x2, int y2);
+};
+
+/*!
+ * @brief 高さマップを生成する
+ * @details 外周1マスは高さの中央値のままとなる.
+ */
+void WildernessHeightMapGenerator::generate()
+{
+    for (auto &row : this->height_map) {
+        row.fill(WILDERNESS_HEIGHT_LEVELS / 2);
+    }
+
+    auto &top_left = this->height_map[1][1];
+    auto &bottom_left = this->height_map[MAX_HGT - 2][1];
+    auto &top_right = this->height_map[1][MAX_WID - 2];
+    auto &bottom_right = this->height_map[MAX_HGT - 2][MAX_WID - 2];
+    top_left = randnum0<short>(WILDERNESS_HEIGHT_LEVELS);
+    bottom_left = randnum0<short>(WILDERNESS_HEIGHT_LEVELS);
+    top_right = randnum0<short>(WILDERNESS_HEIGHT_LEVELS);
+    bottom_right = randnum0<short>(WILDERNESS_HEIGHT_LEVELS);
+    const std::array corners{ top_left, bottom_left, top_right, bottom_right };
+    this->plasma_recursive(1, 1, MAX_WID - 2, MAX_HGT - 2);
+    top_left = corners[0];
+    bottom_left = corners[1];
+    top_right = corners[2];
+    bottom_right = corners[3];
+}
+
+/*!
+ * @brief プラズマフラクタル的地形生成の再帰中間処理
+ * / Helper for plasma generation.
+ * @param x1 左上端の深み
+ * @param x2 右上端の深み
+ * @param x3 左下端の深み
+ * @param x4 右下端の深み
+ * @param xmid 中央座標X
+ * @param ymid 中央座標Y
+ */
+void WildernessHeightMapGenerator::perturb_point_mid(short x1, short x2, short x3, short x4, int xmid, int ymid)
+{
+    const auto tmp = randint1(ROUGHNESS * 2 + 1) - (ROUGHNESS + 1);
+    auto avg = ((x1 + x2 + x3 + x4) / 4) + tmp;
+    if (((x1 + x2 + x3 + x4) % 4) > 1) {
+        avg++;
+    }
+
+    this->height_map[ymid][xmid] = static_cast<short>(std::clamp<int>(avg, 0, DEPTH_MAX));
+}
+
+/*!
+ * @brief プラズマフラクタル的地形生成の再帰末端処理
+ * / Helper for plasma generation.
+ * @param x1 中間末端部1の重み
+ * @param x2 中間末端部2の重み
+ * @param x3 中間末端部3の重み
+ * @param xmid 最終末端部座標X
+ * @param ymid 最終末端部座標Y
+ */
+void WildernessHeightMapGenerator::perturb_point_end(short x1, short x2, short x3, int xmid, int ymid)
+{
+    const auto tmp = randint0(ROUGHNESS * 2 + 1) - ROUGHNESS;
+    auto avg = ((x1 + x2 + x3) / 3) + tmp;
+    if ((x1 + x2 + x3) % 3) {
+        avg++;
+    }
+
+    this->height_map[ymid][xmid] = static_cast<short>(std::clamp<int>(avg, 0, DEPTH_MAX));
+}
+
+/*!
+ * @brief プラズマフラクタル的地形生成の再帰処理
+ * / Helper for plasma generation.
+ * @param x1 処理範囲の左上X座標
+ * @param y1 処理範囲の左上Y座標
+ * @param x2 処理範囲の右下X座標
+ * @param y2 処理範囲の右下Y座標
+ */
+void WildernessHeightMapGenerator::plasma_recursive(int x1, int y1, int x2, int y2)
+{
+    const auto xmid = (x2 - x1) / 2 + x1;
+    const auto ymid = (y2 - y1) / 2 + y1;
+    if (x1 + 1 == x2) {
+        return;
+    }
+
+    const auto &map = this->height_map;
+    this->perturb_point_mid(map[y1][x1], map[y2][x1], map[y1][x2], map[y2][x2], xmid, ymid);
+    this->perturb_point_end(map[y1][x1], map[y1][x2], map[ymid][xmid], xmid, y1);
+    this->perturb_point_end(map[y1][x2], map[y2][x2], map[ymid][xmid], x2, ymid);
+    this->perturb_point_end(map[y2][x2], map[y2][x1], map[ymid][xmid], xmid, y2);
+    this->perturb_point_end(map[y2][x1], map[y1][x1], map[ymid][xmid], x1, ymid);
+    this->plasma_recursive(x1, y1, xmid, ymid);
+    this->plasma_recursive(xmid, y1, x2, ymid);
+    this->plasma_recursive(x1, ymid, xmid, y2);
+    this->plasma_recursive(xmid, ymid, x2, y2);
+}
+
+std::unique_ptr<WildernessHeightMap> generate_height_map(uint32_t seed)
+{
+    const RngStreamScope rng_scope(seed);
+    auto height_map = std::make_unique<WildernessHeightMap>();
+    WildernessHeightMapGenerator(*height_map).generate();
+    return height_map;
+}
+}
+
+WildernessHeightMapCache WildernessHeightMapCache::instance{};
+
+WildernessHeightMapCache &WildernessHeightMapCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief シード値に対応する高さマップを返す
+ * @details キャッシュに無ければその場で生成する. 返した参照は次にキャッシュを操作するまで有効.
+ * @param seed 荒野区画の乱数シード
+ * @return 高さマップ
+ */
+const WildernessHeightMap &WildernessHeightMapCache::get(uint32_t seed)
+{
+    const auto it = this->index.find(seed);
+    if (it == this->index.end()) {
+        return this->insert(seed, generate_height_map(seed));
+    }
+
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return *it->second->second;
+}
+
+/*!
+ * @brief キャッシュに無い高さマップをまとめて並列に生成しておく
+ * @param seeds 荒野区画の乱数シード群
+ */
+void WildernessHeightMapCache::prefetch(std::span<const uint32_t> seeds)
+{
+    std::vector<uint32_t> missing_seeds;
+    for (const auto seed : seeds) {
+        const auto is_missing = !this->index.contains(seed);
+        if (is_missing && (std::find(missing_seeds.begin(), missing_seeds.end(), seed) == missing_seeds.end())) {
+            missing_seeds.push_back(seed);
+        }
+    }
+
+    if (missing_seeds.size() > CAPACITY) {
+        missing_seeds.resize(CAPACITY);
+    }
+
+    std::vector<std::future<std::unique_ptr<WildernessHeightMap>>> futures;
+    for (const auto seed : missing_seeds) {
+        futures.push_back(std::async(std::launch::async, generate_height_map, seed));
+    }
+
+    for (size_t i = 0; i < missing_seeds.size(); ++i) {
+        this->insert(missing_seeds[i], futures[i].get());
+    }
+}
+
+const WildernessHeightMap &WildernessHeightMapCache::insert(uint32_t seed, std::unique_ptr<WildernessHeightMap> height_map)
+{
+    if (this->entries.size() >= CAPACITY) {
+        this->index.erase(this->entries.back().first);
+        this->entries.pop_back();
+    }
+
+    this->entries.emplace_front(seed, std::move(height_map));
+    this->index.emplace(seed, this->entries.begin());
+    return *this->entries.front().second;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "floor/floor-base-definitions.h"
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+/*!
+ * @brief 荒野の高さの段階数 (地形テーブルの要素数と一致させること)
+ */
+constexpr auto WILDERNESS_HEIGHT_LEVELS = 18;
+
+/*!
+ * @brief プラズマフラクタルで生成した荒野1区画分の高さマップ
+ * @details 値は地形IDではなく0～WILDERNESS_HEIGHT_LEVELS-1の高さで、荒野地形の種類に応じて地形IDに変換して使う.
+ */
+using WildernessHeightMap = std::array<std::array<short, MAX_WID>, MAX_HGT>;
+
+/*!
+ * @brief 荒野の高さマップをシード値毎に保持するLRUキャッシュ
+ * @details
+ * 高さマップはシード値だけで決まるので、荒野を移動したりダンジョンから地上へ戻ったりした時に
+ * 同じ区画のプラズマフラクタルを何度も計算し直さずに済むよう、最近使ったものを保持しておく.
+ * 荒野の中央区画と隣接区画を合わせた9区画に加え、1区画移動しても全て収まる数を保持する.
+ */
+class WildernessHeightMapCache {
+public:
+    WildernessHeightMapCache(const WildernessHeightMapCache &) = delete;
+    WildernessHeightMapCache(WildernessHeightMapCache &&) = delete;
+    WildernessHeightMapCache &operator=(const WildernessHeightMapCache &) = delete;
+    WildernessHeightMapCache &operator=(WildernessHeightMapCache &&) = delete;
+
+    static WildernessHeightMapCache &get_instance();
+    const WildernessHeightMap &get(uint32_t seed);
+    void prefetch(std::span<const uint32_t> seeds);
+
+private:
+    WildernessHeightMapCache() = default;
+
+    static constexpr size_t CAPACITY = 16;
+    static WildernessHeightMapCache instance;
+
+    using Entry = std::pair<uint32_t, std::unique_ptr<WildernessHeightMap>>;
+    std::list<Entry> entries; //!< 最近使った順 (先頭が最新)
+    std::unordered_map<uint32_t, std::list<Entry>::iterator> index; //!< シード値からentriesへの索引
+
+    const WildernessHeightMap &insert(uint32_t seed, std::unique_ptr<WildernessHeightMap> height_map);
+};
@@ -17,6 +17,7 @@
 #include "system/redrawing-flags-updater.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
 #include "world/world.h"
 #include <span>
@@ -119,6 +120,7 @@ void cave_set_feat(PlayerType *player_ptr, POSITION y, POSITION x, FEAT_IDX feat
     auto *g_ptr = &floor_ptr->grid_array[y][x];
     const auto &terrain = TerrainList::get_instance().get_terrain(feat);
     const auto &dungeon = floor_ptr->get_dungeon_definition();
+    ProjectionPathCache::get_instance().invalidate();
     if (!AngbandWorld::get_instance().character_dungeon) {
         g_ptr->mimic = 0;
         g_ptr->feat = feat;
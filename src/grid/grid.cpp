@@ -52,6 +52,7 @@
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
 #include "term/gameterm.h"
+#include "target/projection-path-calculator.h"
 #include "term/term-color-types.h"
 #include "timed-effect/timed-effects.h"
 #include "util/bit-flags-calculator.h"
@@ -669,8 +670,8 @@ void update_flow(PlayerType *player_ptr)
 
             /* Add the "children" */
             for (auto d = 0; d < 8; d++) {
-                uint8_t m = grid.costs.at(gf) + 1;
-                const uint8_t n = grid.dists.at(gf) + 1;
+                uint8_t m = grid.get_cost(gf) + 1;
+                const uint8_t n = grid.get_distance(gf) + 1;
                 const Pos2D pos_neighbor(pos.y + ddy_ddd[d], pos.x + ddx_ddd[d]);
 
                 /* Ignore player's grid */
@@ -684,8 +685,8 @@ void update_flow(PlayerType *player_ptr)
 
                 /* Ignore "pre-stamped" entries */
                 auto &grid_neighbor = floor.get_grid(pos_neighbor);
-                auto &cost_neighbor = grid_neighbor.costs.at(gf);
-                auto &dist_neighbor = grid_neighbor.dists.at(gf);
+                auto &cost_neighbor = grid_neighbor.costs[enum2i(gf)];
+                auto &dist_neighbor = grid_neighbor.dists[enum2i(gf)];
                 if ((dist_neighbor != 0) && (dist_neighbor <= n) && (cost_neighbor <= m)) {
                     continue;
                 }
@@ -920,6 +921,7 @@ bool player_can_enter(PlayerType *player_ptr, FEAT_IDX feature, BIT_FLAGS16 mode
 void place_grid(PlayerType *player_ptr, Grid *g_ptr, grid_bold_type gb_type)
 {
     const auto &dungeon = player_ptr->current_floor_ptr->get_dungeon_definition();
+    ProjectionPathCache::get_instance().invalidate();
     switch (gb_type) {
     case GB_FLOOR: {
         g_ptr->feat = rand_choice(feat_ground_type);
@@ -43,6 +43,7 @@ void place_gold(PlayerType *player_ptr, POSITION y, POSITION x)
     item.ix = pos.x;
     floor.o_list[item_idx] = std::move(item);
     grid.o_idx_list.add(&floor, item_idx);
+    floor.spatial_index.update_item(item_idx, pos);
 
     note_spot(player_ptr, pos.y, pos.x);
     lite_spot(player_ptr, pos.y, pos.x);
@@ -84,6 +85,7 @@ void place_object(PlayerType *player_ptr, POSITION y, POSITION x, BIT_FLAGS mode
     item.iy = pos.y;
     item.ix = pos.x;
     grid.o_idx_list.add(&floor, item_idx);
+    floor.spatial_index.update_item(item_idx, pos);
 
     note_spot(player_ptr, pos.y, pos.x);
     lite_spot(player_ptr, pos.y, pos.x);
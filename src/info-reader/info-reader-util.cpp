@@ -8,8 +8,7 @@
 #include "view/display-messages.h"
 
 /* Help give useful error messages */
-int error_idx; /*!< データ読み込み/初期化時に汎用的にエラーコードを保存するグローバル変数 */
-int error_line; /*!< データ読み込み/初期化時に汎用的にエラー行数を保存するグローバル変数 */
+thread_local int error_idx; /*!< データ読み込み/初期化時に汎用的にエラーコードを保存する変数 (ゲームデータは並列に読み込むのでスレッド毎に持つ) */
 
 /*!
  * @brief テキストトークンを走査してフラグを一つ得る(発動能力用) /
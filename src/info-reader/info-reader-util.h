@@ -13,7 +13,7 @@
 /*
  * Size of memory reserved for initialization of some arrays
  */
-extern int error_idx; //!< エラーが発生したinfo ID
+extern thread_local int error_idx; //!< エラーが発生したinfo ID
 
 enum class RandomArtActType : short;
 RandomArtActType grab_one_activation_flag(std::string_view what);
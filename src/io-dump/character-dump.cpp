@@ -45,10 +45,16 @@
 #include "util/enum-converter.h"
 #include "util/int-char-converter.h"
 #include "util/string-processor.h"
+#include "util/task-graph.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
 #include <numeric>
+#include <span>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 /*!
  * @brief プレイヤーのペット情報をファイルにダンプする
@@ -146,7 +152,7 @@ static void dump_aux_last_message(PlayerType *player_ptr, FILE *fff)
 
         for (auto i = 0; i < message_num() && std::size(msg_lines) < msg_line_max; ++i) {
             const auto msg = message_str(i);
-            auto lines = shape_buffer(*msg, msg_width);
+            auto lines = shape_buffer(msg, msg_width);
 
             msg_lines.insert(msg_lines.end(),
                 std::make_move_iterator(lines.rbegin()), std::make_move_iterator(lines.rend()));
@@ -512,44 +518,101 @@ static void dump_aux_equipment_inventory(PlayerType *player_ptr, FILE *fff)
 }
 
 /*!
- * @brief 我が家と博物館のオブジェクト情報をファイルにダンプする
- * @param fff ファイルポインタ
+ * @brief アイテムの記述を並列に作る
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param items 記述するアイテム (互いに異なるもの)
+ * @return 各アイテムの記述
+ * @details
+ * describe_flavor() が書き換えるのは記述するアイテム自身と装備品の特性フラグのキャッシュだけなので、
+ * 装備品の分を先に作っておけば互いに異なるアイテムを別々のスレッドで記述できる.
  */
-static void dump_aux_home_museum(PlayerType *player_ptr, FILE *fff)
+static std::vector<std::string> describe_items(PlayerType *player_ptr, const std::vector<const ItemEntity *> &items)
 {
-    const auto &home = towns_info[1].get_store(StoreSaleType::HOME);
-    if (home.stock_num) {
-        fprintf(fff, _("  [我が家のアイテム]\n", "  [Home Inventory]\n"));
-        auto page = 1;
-        for (auto i = 0; i < home.stock_num; i++) {
-            if ((i % 12) == 0) {
-                fprintf(fff, _("\n ( %d ページ )\n", "\n ( page %d )\n"), page++);
-            }
-
-            const auto item_name = describe_flavor(player_ptr, *home.stock[i], 0);
-            fprintf(fff, "%c) %s\n", I2A(i % 12), item_name.data());
+    constexpr size_t MIN_ITEMS_PER_TASK = 32;
+    for (auto i = 0; i < INVEN_TOTAL; i++) {
+        const auto &item = player_ptr->inventory_list[i];
+        (void)item.get_flags();
+        (void)item.get_flags_known();
+    }
+
+    std::vector<std::string> item_names(items.size());
+    const auto max_tasks = (items.size() + MIN_ITEMS_PER_TASK - 1) / MIN_ITEMS_PER_TASK;
+    const auto num_tasks = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(max_tasks, 1));
+    const auto describe = [player_ptr, &items, &item_names](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            item_names[i] = describe_flavor(player_ptr, *items[i], 0);
         }
+    };
 
-        fprintf(fff, "\n\n");
+    if (num_tasks == 1) {
+        describe(0, items.size());
+        return item_names;
     }
 
-    const auto &museum = towns_info[1].get_store(StoreSaleType::MUSEUM);
-    if (museum.stock_num == 0) {
-        return;
+    TaskGraph task_graph;
+    for (size_t task = 0; task < num_tasks; task++) {
+        const auto begin = items.size() * task / num_tasks;
+        const auto end = items.size() * (task + 1) / num_tasks;
+        task_graph.add(format("describe-items-%zu", task), [&describe, begin, end] { describe(begin, end); });
     }
 
-    fprintf(fff, _("  [博物館のアイテム]\n", "  [Museum]\n"));
+    task_graph.run();
+    return item_names;
+}
+
+/*!
+ * @brief 店に置いてあるアイテムの一覧をダンプ用の文字列にする
+ * @param header 見出し
+ * @param item_names 各アイテムの記述
+ * @return 1ページ12個ずつに区切った一覧
+ */
+static std::string build_store_item_list(std::string_view header, std::span<const std::string> item_names)
+{
+    std::stringstream ss;
+    ss << header;
     auto page = 1;
-    for (auto i = 0; i < museum.stock_num; i++) {
+    for (size_t i = 0; i < item_names.size(); i++) {
         if ((i % 12) == 0) {
-            fprintf(fff, _("\n ( %d ページ )\n", "\n ( page %d )\n"), page++);
+            ss << format(_("\n ( %d ページ )\n", "\n ( page %d )\n"), page++);
         }
 
-        const auto item_name = describe_flavor(player_ptr, *museum.stock[i], 0);
-        fprintf(fff, "%c) %s\n", I2A(i % 12), item_name.data());
+        ss << format("%c) %s\n", I2A(i % 12), item_names[i].data());
     }
 
-    fprintf(fff, "\n\n");
+    ss << "\n\n";
+    return ss.str();
+}
+
+/*!
+ * @brief 我が家と博物館のオブジェクト情報をファイルにダンプする
+ * @param fff ファイルポインタ
+ * @details 大きな我が家や博物館では記述を作るのに時間が掛かるので、全アイテムの記述を並列に作ってから順に書き出す.
+ */
+static void dump_aux_home_museum(PlayerType *player_ptr, FILE *fff)
+{
+    const auto &home = towns_info[1].get_store(StoreSaleType::HOME);
+    const auto &museum = towns_info[1].get_store(StoreSaleType::MUSEUM);
+    std::vector<const ItemEntity *> items;
+    items.reserve(home.stock_num + museum.stock_num);
+    for (auto i = 0; i < home.stock_num; i++) {
+        items.push_back(&*home.stock[i]);
+    }
+
+    for (auto i = 0; i < museum.stock_num; i++) {
+        items.push_back(&*museum.stock[i]);
+    }
+
+    const auto item_names = describe_items(player_ptr, items);
+    const std::span<const std::string> names(item_names);
+    if (home.stock_num) {
+        const auto list = build_store_item_list(_("  [我が家のアイテム]\n", "  [Home Inventory]\n"), names.first(home.stock_num));
+        fputs(list.data(), fff);
+    }
+
+    if (museum.stock_num) {
+        const auto list = build_store_item_list(_("  [博物館のアイテム]\n", "  [Museum]\n"), names.subspan(home.stock_num));
+        fputs(list.data(), fff);
+    }
 }
 
 /*!
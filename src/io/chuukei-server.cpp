@@ -0,0 +1,454 @@
+/*!
+ * @brief 画面の中継配信サーバ
+ * @details
+ * epoll によるイベントループで待ち受け・送信を行う. epoll の無い環境では配信できない.
+ * アドレスは "unix:<パス>" (Unixドメインソケット) または "tcp:[<IPv4アドレス>:]<ポート>" で指定する.
+ * IPv4アドレスを省略した場合はローカルホストからの接続だけを受け付ける.
+ */
+
+#include "io/chuukei-server.h"
+#include "io/movie-file.h"
+#include "system/angband.h"
+#include "term/z-form.h"
+#include "term/z-util.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr uint32_t KEYFRAME_INTERVAL = 100; //!< キーフレームを挟む間隔 (100ms単位)
+constexpr size_t MAX_CATCH_UP_SIZE = 256 * 1024; //!< キーフレーム以降の差分がこれを超えたら次をキーフレームにする
+constexpr size_t MAX_PENDING_SIZE = 1024 * 1024; //!< 観戦者毎の送信待ちの上限
+constexpr auto MAX_EVENTS = 64;
+constexpr auto LISTEN_BACKLOG = 16;
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+namespace {
+/*!
+ * @brief アドレス文字列に従って待ち受けソケットを作る
+ * @param address "unix:<パス>" または "tcp:[<IPv4アドレス>:]<ポート>"
+ * @return ソケット. 失敗したら-1
+ */
+int open_listen_socket(std::string_view address)
+{
+    if (address.starts_with("unix:")) {
+        const auto path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || (path.length() >= sizeof(addr.sun_path))) {
+            return -1;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::copy(path.begin(), path.end(), addr.sun_path);
+        const std::string path_str(path);
+        struct stat path_stat {};
+        if (lstat(path_str.data(), &path_stat) == 0) {
+            if (!S_ISSOCK(path_stat.st_mode)) {
+                plog(format("'%s' already exists and is not a socket.", path_str.data()));
+                return -1;
+            }
+
+            (void)unlink(path_str.data());
+        }
+
+        const auto fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if ((fd < 0) || (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) || (::listen(fd, LISTEN_BACKLOG) != 0)) {
+            if (fd >= 0) {
+                close(fd);
+            }
+
+            return -1;
+        }
+
+        return fd;
+    }
+
+    if (!address.starts_with("tcp:")) {
+        return -1;
+    }
+
+    auto host_port = address.substr(4);
+    std::string host = "127.0.0.1";
+    if (const auto colon = host_port.rfind(':'); colon != std::string_view::npos) {
+        host = host_port.substr(0, colon);
+        host_port = host_port.substr(colon + 1);
+    }
+
+    uint16_t port = 0;
+    const auto [ptr, ec] = std::from_chars(host_port.data(), host_port.data() + host_port.size(), port);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if ((ec != std::errc()) || (ptr != host_port.data() + host_port.size()) || (inet_pton(AF_INET, host.data(), &addr.sin_addr) != 1)) {
+        return -1;
+    }
+
+    const auto fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const auto reuse = 1;
+    if ((fd < 0) || (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0) ||
+        (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) || (::listen(fd, LISTEN_BACKLOG) != 0)) {
+        if (fd >= 0) {
+            close(fd);
+        }
+
+        return -1;
+    }
+
+    return fd;
+}
+}
+
+ChuukeiServer::ChuukeiServer(int listen_fd, int epoll_fd, int wake_fd)
+    : listen_fd(listen_fd)
+    , epoll_fd(epoll_fd)
+    , wake_fd(wake_fd)
+{
+    this->thread = std::thread([this] { this->run(); });
+}
+
+/*!
+ * @brief イベントループを止め、全ての観戦者との接続を閉じる
+ */
+ChuukeiServer::~ChuukeiServer()
+{
+    this->is_stopping = true;
+    this->wake();
+    this->thread.join();
+    for (const auto &[fd, _] : this->clients) {
+        close(fd);
+    }
+
+    close(this->wake_fd);
+    close(this->epoll_fd);
+    close(this->listen_fd);
+}
+
+/*!
+ * @brief 待ち受けを開始する
+ * @param address 待ち受けるアドレス
+ * @return サーバ. 待ち受けられなければnullptr
+ */
+std::unique_ptr<ChuukeiServer> ChuukeiServer::listen(std::string_view address)
+{
+    const auto listen_fd = open_listen_socket(address);
+    if (listen_fd < 0) {
+        return nullptr;
+    }
+
+    const auto epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    const auto wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event listen_event{ .events = EPOLLIN, .data = { .fd = listen_fd } };
+    epoll_event wake_event{ .events = EPOLLIN, .data = { .fd = wake_fd } };
+    if ((epoll_fd < 0) || (wake_fd < 0) || (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_event) != 0) ||
+        (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) != 0)) {
+        for (const auto fd : { listen_fd, epoll_fd, wake_fd }) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        return nullptr;
+    }
+
+    return std::unique_ptr<ChuukeiServer>(new ChuukeiServer(listen_fd, epoll_fd, wake_fd));
+}
+
+/*!
+ * @brief 次のフレームをキーフレームにすべきかを返す
+ * @param time 配信開始からの時刻
+ * @details キーフレーム以降の差分が溜まり過ぎると、追い付きの遅い観戦者へ送り直す量が増えるので早めにキーフレームを挟む.
+ */
+bool ChuukeiServer::is_keyframe_due(uint32_t time) const
+{
+    const std::lock_guard lock(this->mutex);
+    return this->catch_up.empty() || (this->catch_up_size >= MAX_CATCH_UP_SIZE) || (time - this->keyframe_time >= KEYFRAME_INTERVAL);
+}
+
+/*!
+ * @brief フレームを全観戦者へ送る
+ * @param is_keyframe キーフレームか否か
+ * @param time 配信開始からの時刻
+ * @param payload フレームの描画レコードの並び
+ * @details 符号化は1度だけ行い、全観戦者で共有する. 実際の送信はイベントループが行うので、ここでは待たない.
+ */
+void ChuukeiServer::broadcast(bool is_keyframe, uint32_t time, std::string_view payload)
+{
+    auto encoded = std::make_shared<std::string>();
+    append_movie_frame(*encoded, is_keyframe, time, payload);
+    const Chunk chunk = std::move(encoded);
+
+    const std::lock_guard lock(this->mutex);
+    if (is_keyframe) {
+        this->catch_up.clear();
+        this->catch_up_size = 0;
+        this->keyframe_time = time;
+    }
+
+    this->catch_up.push_back(chunk);
+    this->catch_up_size += chunk->size();
+    for (auto &[_, client] : this->clients) {
+        if (client.pending_size + chunk->size() > MAX_PENDING_SIZE) {
+            this->restart_from_keyframe(client);
+            continue;
+        }
+
+        this->enqueue(client, chunk);
+    }
+
+    this->wake();
+}
+
+/*!
+ * @brief イベントループ
+ */
+void ChuukeiServer::run()
+{
+    std::array<epoll_event, MAX_EVENTS> events{};
+    while (!this->is_stopping) {
+        const auto count = epoll_wait(this->epoll_fd, events.data(), MAX_EVENTS, -1);
+        if (count < 0) {
+            continue;
+        }
+
+        const std::lock_guard lock(this->mutex);
+        for (auto i = 0; i < count; i++) {
+            const auto fd = events[i].data.fd;
+            if (fd == this->wake_fd) {
+                uint64_t value;
+                (void)read(this->wake_fd, &value, sizeof(value));
+                this->resume_accepting();
+                for (auto it = this->clients.begin(); it != this->clients.end();) {
+                    const auto client_fd = it->first;
+                    ++it;
+                    auto &client = this->clients.at(client_fd);
+                    if (!client.is_waiting_writable && !this->send_pending(client_fd, client)) {
+                        this->close_client(client_fd);
+                    }
+                }
+
+                continue;
+            }
+
+            if (fd == this->listen_fd) {
+                this->accept_clients();
+                continue;
+            }
+
+            const auto it = this->clients.find(fd);
+            if (it == this->clients.end()) {
+                continue;
+            }
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                this->close_client(fd);
+                continue;
+            }
+
+            if (events[i].events & EPOLLIN) {
+                char discard[256];
+                const auto received = recv(fd, discard, sizeof(discard), 0);
+                if ((received == 0) || ((received < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))) {
+                    this->close_client(fd);
+                    continue;
+                }
+            }
+
+            if ((events[i].events & EPOLLOUT) && !this->send_pending(fd, it->second)) {
+                this->close_client(fd);
+            }
+        }
+    }
+}
+
+/*!
+ * @brief イベントループを起こす
+ */
+void ChuukeiServer::wake() const
+{
+    const uint64_t value = 1;
+    (void)write(this->wake_fd, &value, sizeof(value));
+}
+
+/*!
+ * @brief 接続してきた観戦者を受け付け、ヘッダと現在の画面を送る
+ * @details ファイル記述子が尽きて受け付けられない時は、待ち受けソケットが読み込み可能のままになり
+ * イベントループが空回りするので、受け付けを止める.
+ */
+void ChuukeiServer::accept_clients()
+{
+    while (true) {
+        const auto fd = accept4(this->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if ((errno == ECONNABORTED) || (errno == EINTR)) {
+                continue;
+            }
+
+            if ((errno == EMFILE) || (errno == ENFILE)) {
+                this->pause_accepting();
+            }
+
+            return;
+        }
+
+        epoll_event event{ .events = EPOLLIN, .data = { .fd = fd } };
+        if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        auto &client = this->clients[fd];
+        this->enqueue(client, std::make_shared<const std::string>(get_movie_file_header()));
+        for (const auto &chunk : this->catch_up) {
+            this->enqueue(client, chunk);
+        }
+
+        if (!this->send_pending(fd, client)) {
+            this->close_client(fd);
+        }
+    }
+}
+
+/*!
+ * @brief 待ち受けソケットをイベントループから外し、受け付けを止める
+ * @details 接続待ちの観戦者はそのまま待たせ、受け付けを再開した時に受け付ける.
+ */
+void ChuukeiServer::pause_accepting()
+{
+    if (this->is_accept_paused) {
+        return;
+    }
+
+    (void)epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, this->listen_fd, nullptr);
+    this->is_accept_paused = true;
+}
+
+/*!
+ * @brief 止めていた受け付けを再開する
+ * @details 観戦者との接続を閉じた時と、フレームを配信する度に試みる.
+ * まだファイル記述子が尽きていれば、受け付けようとした時に再び止まる.
+ */
+void ChuukeiServer::resume_accepting()
+{
+    if (!this->is_accept_paused) {
+        return;
+    }
+
+    epoll_event event{ .events = EPOLLIN, .data = { .fd = this->listen_fd } };
+    if (epoll_ctl(this->epoll_fd, EPOLL_CTL_ADD, this->listen_fd, &event) == 0) {
+        this->is_accept_paused = false;
+    }
+}
+
+void ChuukeiServer::enqueue(Client &client, const Chunk &chunk) const
+{
+    client.chunks.push_back(chunk);
+    client.pending_size += chunk->size();
+}
+
+/*!
+ * @brief 送信が追い付かない観戦者の送信待ちを捨て、直近のキーフレームから送り直す
+ * @details 送信途中のチャンクだけは、ストリームが壊れないよう最後まで送る.
+ */
+void ChuukeiServer::restart_from_keyframe(Client &client) const
+{
+    const auto keep_front = (client.sent_size > 0) && !client.chunks.empty();
+    auto front = keep_front ? client.chunks.front() : nullptr;
+    client.chunks.clear();
+    client.pending_size = 0;
+    if (keep_front) {
+        client.chunks.push_back(front);
+        client.pending_size = front->size() - client.sent_size;
+    } else {
+        client.sent_size = 0;
+    }
+
+    for (const auto &chunk : this->catch_up) {
+        this->enqueue(client, chunk);
+    }
+}
+
+/*!
+ * @brief 送信待ちのデータを送れるだけ送る
+ * @return 接続を続けられるか否か
+ * @details 送り切れなければ送信可能になった時に続きを送るよう登録し、送り切ったら登録を外す.
+ */
+bool ChuukeiServer::send_pending(int fd, Client &client)
+{
+    while (!client.chunks.empty()) {
+        const auto &chunk = *client.chunks.front();
+        const auto sent = send(fd, chunk.data() + client.sent_size, chunk.size() - client.sent_size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                return false;
+            }
+
+            break;
+        }
+
+        client.sent_size += sent;
+        client.pending_size -= sent;
+        if (client.sent_size == chunk.size()) {
+            client.chunks.pop_front();
+            client.sent_size = 0;
+        }
+    }
+
+    const auto should_wait_writable = !client.chunks.empty();
+    if (should_wait_writable == client.is_waiting_writable) {
+        return true;
+    }
+
+    epoll_event event{ .events = EPOLLIN | (should_wait_writable ? EPOLLOUT : 0u), .data = { .fd = fd } };
+    client.is_waiting_writable = should_wait_writable;
+    return epoll_ctl(this->epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void ChuukeiServer::close_client(int fd)
+{
+    (void)epoll_ctl(this->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    this->clients.erase(fd);
+    this->resume_accepting();
+}
+#else
+ChuukeiServer::ChuukeiServer(int listen_fd, int epoll_fd, int wake_fd)
+    : listen_fd(listen_fd)
+    , epoll_fd(epoll_fd)
+    , wake_fd(wake_fd)
+{
+}
+
+ChuukeiServer::~ChuukeiServer() = default;
+
+std::unique_ptr<ChuukeiServer> ChuukeiServer::listen(std::string_view address)
+{
+    (void)address;
+    return nullptr;
+}
+
+bool ChuukeiServer::is_keyframe_due(uint32_t time) const
+{
+    (void)time;
+    return false;
+}
+
+void ChuukeiServer::broadcast(bool is_keyframe, uint32_t time, std::string_view payload)
+{
+    (void)is_keyframe;
+    (void)time;
+    (void)payload;
+}
+#endif
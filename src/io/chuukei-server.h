@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*!
+ * @brief 画面を観戦者へ配信する中継サーバ
+ * @details
+ * ゲーム側で1度だけ符号化したフレームを、専用スレッドのイベントループが全観戦者へ非同期に送る.
+ * 送信が追い付かない観戦者の分はゲームを待たせずに捨て、直近のキーフレームとそれ以降の差分から送り直す.
+ * 新しい観戦者にも同じものを送るので、接続した時点の画面からすぐに見始められる.
+ * ストリームは索引付きムービーファイルと同じ形式なので、受信したものを保存すれば -x で再生できる.
+ */
+class ChuukeiServer {
+public:
+    ~ChuukeiServer();
+    ChuukeiServer(const ChuukeiServer &) = delete;
+    ChuukeiServer &operator=(const ChuukeiServer &) = delete;
+    ChuukeiServer(ChuukeiServer &&) = delete;
+    ChuukeiServer &operator=(ChuukeiServer &&) = delete;
+
+    static std::unique_ptr<ChuukeiServer> listen(std::string_view address);
+    bool is_keyframe_due(uint32_t time) const;
+    void broadcast(bool is_keyframe, uint32_t time, std::string_view payload);
+
+private:
+    using Chunk = std::shared_ptr<const std::string>;
+
+    /*!
+     * @brief 観戦者1人分の送信待ちデータ
+     */
+    struct Client {
+        std::deque<Chunk> chunks;
+        size_t sent_size = 0; //!< 先頭のチャンクのうち送信済みのバイト数
+        size_t pending_size = 0; //!< 未送信のバイト数
+        bool is_waiting_writable = false; //!< 送信可能になるのを待っているか
+    };
+
+    ChuukeiServer(int listen_fd, int epoll_fd, int wake_fd);
+
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd;
+    std::thread thread;
+    std::atomic<bool> is_stopping = false;
+    bool is_accept_paused = false; //!< ファイル記述子が尽きて受け付けを止めているか
+
+    mutable std::mutex mutex;
+    std::map<int, Client> clients;
+    std::vector<Chunk> catch_up; //!< 直近のキーフレームとそれ以降の差分
+    size_t catch_up_size = 0;
+    uint32_t keyframe_time = 0;
+
+    void run();
+    void wake() const;
+    void accept_clients();
+    void pause_accepting();
+    void resume_accepting();
+    void enqueue(Client &client, const Chunk &chunk) const;
+    void restart_from_keyframe(Client &client) const;
+    bool send_pending(int fd, Client &client);
+    void close_client(int fd);
+};
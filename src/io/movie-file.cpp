@@ -0,0 +1,329 @@
+/*!
+ * @brief 索引付きムービーファイルの読み書き
+ * @details
+ * ファイルの構造は以下の通り. 数値は全てリトルエンディアン.
+ *   ヘッダ: MOVIE_MAGIC (8バイト)
+ *   フレーム: 種別 ('K' キーフレーム / 'D' 差分) (1) 時刻 (4) ペイロード長 (4) ペイロード
+ *   索引: (時刻 (4) キーフレームの位置 (8)) × キーフレーム数
+ *   フッタ: 索引の位置 (8) キーフレーム数 (4) INDEX_MAGIC (8)
+ * ペイロードは従来のムービーと同じ描画レコードを区切り文字無しで並べたもの.
+ * キーフレームは画面の消去から始まり画面全体を描くので、そこからは前のフレーム無しで再生できる.
+ */
+
+#include "io/movie-file.h"
+#include "system/angband.h"
+#include "util/angband-files.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace {
+constexpr std::string_view MOVIE_MAGIC("HBAMV2\r\n", 8);
+constexpr std::string_view INDEX_MAGIC("HBAMVIDX", 8);
+constexpr auto FRAME_HEADER_SIZE = 9;
+constexpr auto INDEX_ENTRY_SIZE = 12;
+constexpr auto FOOTER_SIZE = 20;
+constexpr uint32_t KEYFRAME_INTERVAL = 100; //!< キーフレームを挟む間隔 (100ms単位)
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024; //!< これ以上溜まったら書き込む
+
+template <typename T>
+void put_le(std::string &buffer, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+template <typename T>
+T get_le(const char *data)
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+
+    return value;
+}
+}
+
+/*!
+ * @brief 描画レコードの先頭部分を作る
+ * @param id レコードの種別
+ * @param fields 座標・長さ・色・文字など、1バイトずつ続く値
+ * @return 描画レコード. 文字列のレコードは続けて文字列本体を付け加える
+ * @details 色は0 (TERM_DARK) もあり得るので、ヌル終端を前提とする format() ではなく1バイトずつ詰める.
+ */
+std::string make_movie_record(char id, std::initializer_list<int> fields)
+{
+    std::string record(1, id);
+    for (const auto field : fields) {
+        record.push_back(static_cast<char>(field));
+    }
+
+    return record;
+}
+
+/*!
+ * @brief 区切り文字の無い描画レコードの長さを返す
+ * @param record 描画レコードの並び
+ * @return 先頭の描画レコードの長さ. 壊れていれば0
+ */
+size_t get_movie_record_length(std::string_view record)
+{
+    if (record.empty()) {
+        return 0;
+    }
+
+    switch (record[0]) {
+    case 't':
+        return record.length() >= 5 ? 5 + static_cast<uint8_t>(record[3]) : 0;
+    case 'n':
+        return 6;
+    case 's':
+        return 5;
+    case 'w':
+        return 4;
+    case 'x':
+        return 2;
+    case 'c':
+    case 'C':
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/*!
+ * @brief 索引付きムービーのファイルヘッダを返す
+ * @details 配信ストリームもこのヘッダとフレームの列で構成するので、受信したものをそのまま保存すれば再生できる.
+ */
+std::string_view get_movie_file_header()
+{
+    return MOVIE_MAGIC;
+}
+
+/*!
+ * @brief フレームを符号化して追加する
+ * @param buffer 追加先
+ * @param is_keyframe キーフレームか否か
+ * @param time 録画開始からの時刻
+ * @param payload フレームの描画レコードの並び
+ */
+void append_movie_frame(std::string &buffer, bool is_keyframe, uint32_t time, std::string_view payload)
+{
+    buffer.push_back(is_keyframe ? 'K' : 'D');
+    put_le(buffer, time);
+    put_le(buffer, static_cast<uint32_t>(payload.size()));
+    buffer.append(payload);
+}
+
+/*!
+ * @brief 書き込みを開始し、ヘッダを書く
+ * @param fd 書き込み用に開いたファイル. 以後このクラスが閉じる
+ */
+MovieWriter::MovieWriter(int fd)
+    : fd(fd)
+{
+    this->buffer.append(MOVIE_MAGIC);
+}
+
+/*!
+ * @brief 索引とフッタを書いてファイルを閉じる
+ */
+MovieWriter::~MovieWriter()
+{
+    const auto index_offset = this->written_size + this->buffer.size();
+    for (const auto &entry : this->index) {
+        put_le(this->buffer, entry.time);
+        put_le(this->buffer, entry.offset);
+    }
+
+    put_le<uint64_t>(this->buffer, index_offset);
+    put_le(this->buffer, static_cast<uint32_t>(this->index.size()));
+    this->buffer.append(INDEX_MAGIC);
+    this->flush();
+    (void)fd_close(this->fd);
+}
+
+/*!
+ * @brief 次のフレームをキーフレームにすべきかを返す
+ * @param time 録画開始からの時刻
+ */
+bool MovieWriter::is_keyframe_due(uint32_t time) const
+{
+    return this->index.empty() || (time - this->index.back().time >= KEYFRAME_INTERVAL);
+}
+
+/*!
+ * @brief フレームを書き込み待ちにする
+ * @param is_keyframe キーフレームか否か
+ * @param time 録画開始からの時刻
+ * @param payload フレームの描画レコードの並び
+ */
+void MovieWriter::write_frame(bool is_keyframe, uint32_t time, std::string_view payload)
+{
+    if (is_keyframe) {
+        this->index.push_back({ time, this->written_size + this->buffer.size() });
+    }
+
+    append_movie_frame(this->buffer, is_keyframe, time, payload);
+    if (this->buffer.size() >= FLUSH_THRESHOLD) {
+        this->flush();
+    }
+}
+
+/*!
+ * @brief 書き込み待ちのデータをファイルに書く
+ */
+void MovieWriter::flush()
+{
+    if (this->buffer.empty()) {
+        return;
+    }
+
+    (void)fd_write(this->fd, this->buffer.data(), this->buffer.size());
+    this->written_size += this->buffer.size();
+    this->buffer.clear();
+}
+
+/*!
+ * @brief ファイルを開いて索引を読む
+ * @param fd 読み込み用に開いたファイル
+ */
+MovieReader::MovieReader(int fd)
+    : fd(fd)
+    , offset(MOVIE_MAGIC.size())
+    , data_end(MOVIE_MAGIC.size())
+{
+    const auto file_size = lseek(fd, 0, SEEK_END);
+    if (file_size < 0) {
+        return;
+    }
+
+    if (!this->read_index(file_size)) {
+        this->rebuild_index(file_size);
+    }
+}
+
+/*!
+ * @brief ファイルが索引付きムービーか調べる
+ * @param fd 読み込み用に開いたファイル
+ * @return 索引付きムービーか否か. ファイルの読み込み位置は先頭に戻す
+ */
+bool MovieReader::is_indexed_movie(int fd)
+{
+    std::array<char, MOVIE_MAGIC.size()> magic{};
+    const auto is_read = fd_read(fd, magic.data(), magic.size()) == 0;
+    (void)fd_seek(fd, 0);
+    return is_read && (std::string_view(magic.data(), magic.size()) == MOVIE_MAGIC);
+}
+
+/*!
+ * @brief 次のフレームを読む
+ * @return フレーム. 最後まで読んでいればstd::nullopt
+ */
+std::optional<MovieFrame> MovieReader::read_frame()
+{
+    if (this->offset + FRAME_HEADER_SIZE > this->data_end) {
+        return std::nullopt;
+    }
+
+    std::array<char, FRAME_HEADER_SIZE> header{};
+    if ((fd_seek(this->fd, this->offset) != 0) || (fd_read(this->fd, header.data(), header.size()) != 0)) {
+        return std::nullopt;
+    }
+
+    const auto size = get_le<uint32_t>(&header[5]);
+    if (this->offset + FRAME_HEADER_SIZE + size > this->data_end) {
+        return std::nullopt;
+    }
+
+    MovieFrame frame{ header[0] == 'K', get_le<uint32_t>(&header[1]), std::string(size, '\0') };
+    if ((size > 0) && (fd_read(this->fd, frame.payload.data(), size) != 0)) {
+        return std::nullopt;
+    }
+
+    this->offset += FRAME_HEADER_SIZE + size;
+    return frame;
+}
+
+/*!
+ * @brief 指定時刻以前で最も遅いキーフレームへ移動する
+ * @param time 録画開始からの時刻
+ * @details そのようなキーフレームが無ければ先頭へ移動する.
+ */
+void MovieReader::seek(uint32_t time)
+{
+    const auto it = std::upper_bound(this->index.begin(), this->index.end(), time, [](uint32_t t, const MovieIndexEntry &entry) {
+        return t < entry.time;
+    });
+    this->offset = (it == this->index.begin()) ? MOVIE_MAGIC.size() : std::prev(it)->offset;
+}
+
+/*!
+ * @brief ファイル末尾の索引を読む
+ * @param file_size ファイルの大きさ
+ * @return 索引が揃っていたか否か
+ */
+bool MovieReader::read_index(uint64_t file_size)
+{
+    if (file_size < MOVIE_MAGIC.size() + FOOTER_SIZE) {
+        return false;
+    }
+
+    std::array<char, FOOTER_SIZE> footer{};
+    if ((fd_seek(this->fd, file_size - FOOTER_SIZE) != 0) || (fd_read(this->fd, footer.data(), footer.size()) != 0)) {
+        return false;
+    }
+
+    const auto index_offset = get_le<uint64_t>(&footer[0]);
+    const auto count = get_le<uint32_t>(&footer[8]);
+    const auto is_valid = (std::string_view(&footer[12], INDEX_MAGIC.size()) == INDEX_MAGIC) && (index_offset >= MOVIE_MAGIC.size()) &&
+                          (index_offset + static_cast<uint64_t>(count) * INDEX_ENTRY_SIZE + FOOTER_SIZE == file_size);
+    if (!is_valid) {
+        return false;
+    }
+
+    std::string entries(count * INDEX_ENTRY_SIZE, '\0');
+    if ((fd_seek(this->fd, index_offset) != 0) || (!entries.empty() && (fd_read(this->fd, entries.data(), entries.size()) != 0))) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const auto *entry = &entries[i * INDEX_ENTRY_SIZE];
+        this->index.push_back({ get_le<uint32_t>(entry), get_le<uint64_t>(entry + 4) });
+    }
+
+    this->data_end = index_offset;
+    return true;
+}
+
+/*!
+ * @brief フレームを先頭から辿って索引を作り直す
+ * @param file_size ファイルの大きさ
+ * @details 途中で切れているフレームの手前までを再生範囲とする.
+ */
+void MovieReader::rebuild_index(uint64_t file_size)
+{
+    this->index.clear();
+    uint64_t pos = MOVIE_MAGIC.size();
+    std::array<char, FRAME_HEADER_SIZE> header{};
+    while (pos + FRAME_HEADER_SIZE <= file_size) {
+        if ((fd_seek(this->fd, pos) != 0) || (fd_read(this->fd, header.data(), header.size()) != 0)) {
+            break;
+        }
+
+        const auto next = pos + FRAME_HEADER_SIZE + get_le<uint32_t>(&header[5]);
+        if (((header[0] != 'K') && (header[0] != 'D')) || (next > file_size)) {
+            break;
+        }
+
+        if (header[0] == 'K') {
+            this->index.push_back({ get_le<uint32_t>(&header[1]), pos });
+        }
+
+        pos = next;
+    }
+
+    this->data_end = pos;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief 索引付きムービーファイルの1フレーム
+ */
+struct MovieFrame {
+    bool is_keyframe; //!< 画面全体を描き直すフレームか否か
+    uint32_t time; //!< 録画開始からの時刻 (100ms単位)
+    std::string payload; //!< 描画レコードの列
+};
+
+/*!
+ * @brief キーフレームの索引
+ */
+struct MovieIndexEntry {
+    uint32_t time; //!< キーフレームの時刻
+    uint64_t offset; //!< キーフレームのファイル内の位置
+};
+
+std::string make_movie_record(char id, std::initializer_list<int> fields);
+size_t get_movie_record_length(std::string_view record);
+std::string_view get_movie_file_header();
+void append_movie_frame(std::string &buffer, bool is_keyframe, uint32_t time, std::string_view payload);
+
+/*!
+ * @brief 索引付きムービーファイルの書き込みクラス
+ * @details
+ * term_fresh() 単位のフレームをメモリ上に溜めてから書き込む.
+ * 終了時にキーフレームの索引をファイル末尾に付け加える.
+ */
+class MovieWriter {
+public:
+    explicit MovieWriter(int fd);
+    ~MovieWriter();
+    MovieWriter(const MovieWriter &) = delete;
+    MovieWriter &operator=(const MovieWriter &) = delete;
+    MovieWriter(MovieWriter &&) = delete;
+    MovieWriter &operator=(MovieWriter &&) = delete;
+
+    bool is_keyframe_due(uint32_t time) const;
+    void write_frame(bool is_keyframe, uint32_t time, std::string_view payload);
+    void flush();
+
+private:
+    int fd;
+    std::string buffer; //!< ファイルへ未書き込みのデータ
+    uint64_t written_size = 0; //!< ファイルへ書き込み済みのバイト数
+    std::vector<MovieIndexEntry> index;
+};
+
+/*!
+ * @brief 索引付きムービーファイルの読み込みクラス
+ * @details 末尾の索引が無い (録画中に終了した) ファイルは、開く時に先頭から走査して索引を作り直す.
+ */
+class MovieReader {
+public:
+    explicit MovieReader(int fd);
+
+    static bool is_indexed_movie(int fd);
+    std::optional<MovieFrame> read_frame();
+    void seek(uint32_t time);
+
+private:
+    int fd;
+    uint64_t offset; //!< 次に読むフレームの位置
+    uint64_t data_end; //!< フレームが続く範囲の終端
+    std::vector<MovieIndexEntry> index;
+
+    bool read_index(uint64_t file_size);
+    void rebuild_index(uint64_t file_size);
+};
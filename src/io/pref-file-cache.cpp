@@ -0,0 +1,123 @@
+#include "io/pref-file-cache.h"
+#include "io/pref-file-expressor.h"
+#include "locale/japanese.h"
+#include "system/angband.h"
+#include "util/angband-files.h"
+#include <algorithm>
+
+PrefFileCache PrefFileCache::instance{};
+
+/*!
+ * @brief 条件式から参照する変数を抜き出す
+ * @param expression 条件式 ("?:" を除く)
+ */
+PrefFileCondition::PrefFileCondition(std::string_view expression)
+    : expression(expression)
+{
+    for (auto pos = expression.find('$'); pos != std::string_view::npos; pos = expression.find('$', pos)) {
+        const auto end = std::min(expression.find_first_of(" []", pos), expression.size());
+        std::string variable(expression.substr(pos + 1, end - pos - 1));
+        if (std::find(this->variables.begin(), this->variables.end(), variable) == this->variables.end()) {
+            this->variables.push_back(std::move(variable));
+        }
+
+        pos = end;
+    }
+}
+
+/*!
+ * @brief 条件を満たすかを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 式の値が "0" 以外か否か
+ */
+bool PrefFileCondition::is_satisfied(PlayerType *player_ptr) const
+{
+    std::vector<std::string> values;
+    values.reserve(this->variables.size());
+    for (const auto &variable : this->variables) {
+        values.push_back(get_pref_file_variable(player_ptr, variable));
+    }
+
+    if (this->last_result && (values == this->last_values)) {
+        return *this->last_result;
+    }
+
+    auto buf = this->expression;
+    auto *s = buf.data();
+    char f;
+    this->last_result = process_pref_file_expr(player_ptr, &s, &f) != "0";
+    this->last_values = std::move(values);
+    return *this->last_result;
+}
+
+PrefFileCache &PrefFileCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief prfファイルを解釈済みの形で返す
+ * @param path prfファイルのパス
+ * @return 解釈済みの各行. ファイルを開けなければnullptr
+ * @details ファイルが更新されていなければ、前回読んだ内容を使う.
+ */
+std::shared_ptr<const PrefFileLines> PrefFileCache::find(const std::filesystem::path &path)
+{
+    const auto &parsed_path = path_parse(path);
+    std::error_code ec;
+    const auto write_time = std::filesystem::last_write_time(parsed_path, ec);
+    const auto size = ec ? 0 : std::filesystem::file_size(parsed_path, ec);
+    if (ec) {
+        this->entries.erase(path);
+        return nullptr;
+    }
+
+    if (const auto it = this->entries.find(path); (it != this->entries.end()) && (it->second.write_time == write_time) && (it->second.size == size)) {
+        return it->second.lines;
+    }
+
+    auto *fp = angband_fopen(path, FileOpenMode::READ);
+    if (!fp) {
+        return nullptr;
+    }
+
+    auto lines = std::make_shared<PrefFileLines>();
+    for (auto line_num = 0;; line_num++) {
+        auto line_str = angband_fgets(fp);
+        if (!line_str) {
+            break;
+        }
+
+        if (line_str->empty()) {
+            continue;
+        }
+
+#ifdef JP
+        if (!iskanji(line_str->front()))
+#endif
+            if (iswspace(line_str->front())) {
+                continue;
+            }
+
+        if (line_str->starts_with('#')) {
+            continue;
+        }
+
+        if (line_str->starts_with("?:")) {
+            const auto expression = std::string_view(*line_str).substr(2);
+            lines->push_back({ PrefFileLineType::CONDITION, line_num, *line_str, PrefFileCondition(expression) });
+            continue;
+        }
+
+        if (line_str->starts_with("%:")) {
+            lines->push_back({ PrefFileLineType::INCLUDE, line_num, line_str->substr(2), std::nullopt });
+            continue;
+        }
+
+        lines->push_back({ PrefFileLineType::COMMAND, line_num, std::move(*line_str), std::nullopt });
+    }
+
+    angband_fclose(fp);
+    this->entries[path] = { write_time, size, lines };
+    return lines;
+}
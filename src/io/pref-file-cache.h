@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class PrefFileLineType {
+    CONDITION, //!< ?:<条件式>
+    INCLUDE, //!< %:<ファイル名>
+    COMMAND, //!< その他の設定行
+};
+
+class PlayerType;
+
+/*!
+ * @brief prefファイルの条件分岐式
+ * @details 式が参照する変数の値が前回の評価時と同じならば、式を解釈し直さずに前回の結果を返す.
+ */
+class PrefFileCondition {
+public:
+    explicit PrefFileCondition(std::string_view expression);
+
+    bool is_satisfied(PlayerType *player_ptr) const;
+
+private:
+    std::string expression;
+    std::vector<std::string> variables; //!< 式が参照する変数名 ('$' を除く)
+    mutable std::vector<std::string> last_values; //!< 前回の評価時の変数の値
+    mutable std::optional<bool> last_result;
+};
+
+/*!
+ * @brief 解釈済みのprfファイルの1行
+ */
+struct PrefFileLine {
+    PrefFileLineType type;
+    int line_num; //!< ファイル内の行番号 (0から数える)
+    std::string text; //!< 条件式・ファイル名・設定行
+    std::optional<PrefFileCondition> condition;
+};
+
+using PrefFileLines = std::vector<PrefFileLine>;
+
+/*!
+ * @brief 解釈済みのprfファイルのキャッシュ
+ * @details
+ * 空行・コメントを除き、各行を種別毎に分けて保持する.
+ * ファイルの更新時刻か大きさが変わっていたら読み直す.
+ */
+class PrefFileCache {
+public:
+    PrefFileCache(const PrefFileCache &) = delete;
+    PrefFileCache(PrefFileCache &&) = delete;
+    PrefFileCache &operator=(const PrefFileCache &) = delete;
+    PrefFileCache &operator=(PrefFileCache &&) = delete;
+
+    static PrefFileCache &get_instance();
+    std::shared_ptr<const PrefFileLines> find(const std::filesystem::path &path);
+
+private:
+    PrefFileCache() = default;
+
+    /*!
+     * @brief キャッシュした時点のファイルの状態と内容
+     */
+    struct Entry {
+        std::filesystem::file_time_type write_time;
+        uintmax_t size;
+        std::shared_ptr<const PrefFileLines> lines;
+    };
+
+    static PrefFileCache instance;
+    std::map<std::filesystem::path, Entry> entries;
+};
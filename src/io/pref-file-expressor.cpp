@@ -8,6 +8,77 @@
 #include "term/z-form.h"
 #include "util/string-processor.h"
 
+/*!
+ * @brief 条件分岐式の変数の値を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param name 変数名 ('$' を除く)
+ * @return 変数の値. 未知の変数ならば "?o?o?"
+ */
+std::string get_pref_file_variable(PlayerType *player_ptr, std::string_view name)
+{
+    if (name == "SYS") {
+        return ANGBAND_SYS;
+    }
+
+    if (name == "KEYBOARD") {
+        return ANGBAND_KEYBOARD;
+    }
+
+    if (name == "GRAF") {
+        return ANGBAND_GRAF;
+    }
+
+    if (name == "MONOCHROME") {
+        return arg_monochrome ? "ON" : "OFF";
+    }
+
+    if (name == "RACE") {
+        return rp_ptr->title.en_string();
+    }
+
+    if (name == "CLASS") {
+        return cp_ptr->title.en_string();
+    }
+
+    if (name == "PLAYER") {
+        std::string player_name;
+        for (auto pn = player_ptr->name; *pn; pn++) {
+#ifdef JP
+            if (iskanji(*pn)) {
+                player_name.push_back(*(pn++));
+                player_name.push_back(*pn);
+                continue;
+            }
+#endif
+            player_name.push_back(angband_strchr(" []", *pn) ? '_' : *pn);
+        }
+
+        return player_name;
+    }
+
+    if (name == "REALM1") {
+        return PlayerRealm(player_ptr).realm1().get_name().en_string();
+    }
+
+    if (name == "REALM2") {
+        return PlayerRealm(player_ptr).realm2().get_name().en_string();
+    }
+
+    if (name == "LEVEL") {
+        return format("%02d", player_ptr->lev);
+    }
+
+    if (name == "AUTOREGISTER") {
+        return player_ptr->autopick_autoregister ? "1" : "0";
+    }
+
+    if (name == "MONEY") {
+        return format("%09ld", (long int)player_ptr->au);
+    }
+
+    return "?o?o?";
+}
+
 /*!
  * @brief process_pref_fileのサブルーチンとして条件分岐処理の解釈と結果を返す
  * Helper function for "process_pref_file()"
@@ -150,54 +221,7 @@ std::string process_pref_file_expr(PlayerType *player_ptr, char **sp, char *fp)
         return v;
     }
 
-    if (streq(b + 1, "SYS")) {
-        v = ANGBAND_SYS;
-    } else if (streq(b + 1, "KEYBOARD")) {
-        v = ANGBAND_KEYBOARD;
-    } else if (streq(b + 1, "GRAF")) {
-        v = ANGBAND_GRAF;
-    } else if (streq(b + 1, "MONOCHROME")) {
-        if (arg_monochrome) {
-            v = "ON";
-        } else {
-            v = "OFF";
-        }
-    } else if (streq(b + 1, "RACE")) {
-        v = rp_ptr->title.en_string();
-    } else if (streq(b + 1, "CLASS")) {
-        v = cp_ptr->title.en_string();
-    } else if (streq(b + 1, "PLAYER")) {
-        static char tmp_player_name[32];
-        char *pn, *tpn;
-        for (pn = player_ptr->name, tpn = tmp_player_name; *pn; pn++, tpn++) {
-#ifdef JP
-            if (iskanji(*pn)) {
-                *(tpn++) = *(pn++);
-                *tpn = *pn;
-                continue;
-            }
-#endif
-            *tpn = angband_strchr(" []", *pn) ? '_' : *pn;
-        }
-
-        *tpn = '\0';
-        v = tmp_player_name;
-    } else if (streq(b + 1, "REALM1")) {
-        v = PlayerRealm(player_ptr).realm1().get_name().en_string();
-    } else if (streq(b + 1, "REALM2")) {
-        v = PlayerRealm(player_ptr).realm2().get_name().en_string();
-    } else if (streq(b + 1, "LEVEL")) {
-        v = format("%02d", player_ptr->lev);
-    } else if (streq(b + 1, "AUTOREGISTER")) {
-        if (player_ptr->autopick_autoregister) {
-            v = "1";
-        } else {
-            v = "0";
-        }
-    } else if (streq(b + 1, "MONEY")) {
-        v = format("%09ld", (long int)player_ptr->au);
-    }
-
+    v = get_pref_file_variable(player_ptr, b + 1);
     *fp = f;
     *sp = s;
     return v;
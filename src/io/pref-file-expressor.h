@@ -2,6 +2,8 @@
 
 #include "system/angband.h"
 #include <string>
+#include <string_view>
 
 class PlayerType;
+std::string get_pref_file_variable(PlayerType *player_ptr, std::string_view name);
 std::string process_pref_file_expr(PlayerType *player_ptr, char **sp, char *fp);
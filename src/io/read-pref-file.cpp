@@ -11,7 +11,7 @@
 #include "io-dump/dump-remover.h"
 #include "io/files-util.h"
 #include "io/interpret-pref-file.h"
-#include "io/pref-file-expressor.h"
+#include "io/pref-file-cache.h"
 #include "player-info/class-info.h"
 #include "player-info/race-info.h"
 #include "player/player-realm.h"
@@ -47,12 +47,13 @@ static int auto_dump_line_num;
  * @param name 読み込むファイル名
  * @param preftype prefファイルのタイプ
  * @return エラーコード
+ * @details 行の読み込みと分類は PrefFileCache が行い、ファイルが更新されるまで使い回す.
  * @todo 関数名を変更する
  */
 static errr process_pref_file_aux(PlayerType *player_ptr, const std::filesystem::path &name, int preftype)
 {
-    auto *fp = angband_fopen(name, FileOpenMode::READ);
-    if (!fp) {
+    const auto lines = PrefFileCache::get_instance().find(name);
+    if (!lines) {
         return -1;
     }
 
@@ -60,34 +61,13 @@ static errr process_pref_file_aux(PlayerType *player_ptr, const std::filesystem:
     errr err = 0;
     bool bypass = false;
     std::string error_line;
-    while (true) {
-        auto line_str = angband_fgets(fp);
-        if (!line_str) {
-            break;
-        }
-        line++;
-        if (line_str->empty()) {
-            continue;
-        }
-
-#ifdef JP
-        if (!iskanji(line_str->front()))
-#endif
-            if (iswspace(line_str->front())) {
-                continue;
-            }
-
-        if (line_str->starts_with('#')) {
-            continue;
-        }
-        error_line = *line_str;
+    for (const auto &pref_line : *lines) {
+        line = pref_line.line_num;
+        error_line = pref_line.text;
 
         /* Process "?:<expr>" */
-        if (line_str->starts_with("?:")) {
-            char f;
-            char *s = line_str->data() + 2;
-            auto v = process_pref_file_expr(player_ptr, &s, &f);
-            bypass = v == "0";
+        if (pref_line.type == PrefFileLineType::CONDITION) {
+            bypass = !pref_line.condition->is_satisfied(player_ptr);
             continue;
         }
 
@@ -96,24 +76,22 @@ static errr process_pref_file_aux(PlayerType *player_ptr, const std::filesystem:
         }
 
         /* Process "%:<file>" */
-        if (line_str->starts_with("%:")) {
+        if (pref_line.type == PrefFileLineType::INCLUDE) {
             static int depth_count = 0;
             if (depth_count > 20) {
                 continue;
             }
 
             depth_count++;
-            std::string_view file(*line_str);
-            file.remove_prefix(2);
             switch (preftype) {
             case PREF_TYPE_AUTOPICK:
-                (void)process_autopick_file(player_ptr, file);
+                (void)process_autopick_file(player_ptr, pref_line.text);
                 break;
             case PREF_TYPE_HISTPREF:
-                (void)process_histpref_file(player_ptr, file);
+                (void)process_histpref_file(player_ptr, pref_line.text);
                 break;
             default:
-                (void)process_pref_file(player_ptr, file);
+                (void)process_pref_file(player_ptr, pref_line.text);
                 break;
             }
 
@@ -121,13 +99,14 @@ static errr process_pref_file_aux(PlayerType *player_ptr, const std::filesystem:
             continue;
         }
 
-        err = interpret_pref_file(player_ptr, line_str->data());
+        auto line_str = pref_line.text;
+        err = interpret_pref_file(player_ptr, line_str.data());
         if (err != 0) {
             if (preftype != PREF_TYPE_AUTOPICK) {
                 break;
             }
 
-            process_autopick_file_command(line_str->data());
+            process_autopick_file_command(line_str.data());
             err = 0;
         }
     }
@@ -141,7 +120,6 @@ static errr process_pref_file_aux(PlayerType *player_ptr, const std::filesystem:
         msg_print(nullptr);
     }
 
-    angband_fclose(fp);
     return err;
 }
 
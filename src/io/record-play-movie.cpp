@@ -8,15 +8,18 @@
 #include "cmd-io/cmd-dump.h"
 #include "cmd-visual/cmd-draw.h"
 #include "core/asking-player.h"
+#include "io/chuukei-server.h"
 #include "io/files-util.h"
+#include "io/movie-file.h"
 #include "io/signal-handlers.h"
 #include "locale/japanese.h"
 #include "system/player-type-definition.h"
 #include "term/gameterm.h"
-#include "term/z-form.h"
 #include "util/angband-files.h"
+#include "util/int-char-converter.h"
 #include "view/display-messages.h"
 #include <algorithm>
+#include <memory>
 #include <sstream>
 #include <vector>
 
@@ -38,10 +41,18 @@
 /* 「n」、「t」、および「w」コマンドでは、長さが「signed char」に配置されるときに負の値を回避するために、これよりも長い長さを使用しないでください。 */
 static constexpr auto SPLIT_MAX = 127;
 
+/* 再生中の早送り倍率の上限 */
+static constexpr auto MAX_BROWSE_SPEED = 64;
+/* 「[」「]」キーで移動する時間(100ms単位) */
+static constexpr auto BROWSE_SEEK_STEP = 600;
+
 static long epoch_time; /* バッファ開始時刻 */
 static int browse_delay; /* 表示するまでの時間(100ms単位)(この間にラグを吸収する) */
 static int movie_fd;
 static int movie_mode;
+static std::unique_ptr<MovieWriter> movie_writer; /* 録画中のムービーファイル */
+static std::unique_ptr<ChuukeiServer> chuukei_server; /* 画面の配信先 */
+static std::string movie_frame; /* 録画・配信中のフレームの描画レコード */
 
 /* 描画する時刻を覚えておくキュー構造体 */
 static struct {
@@ -67,6 +78,14 @@ static errr (*old_bigcurs_hook)(int x, int y);
 static errr (*old_wipe_hook)(int x, int y, int n);
 static errr (*old_text_hook)(int x, int y, int n, TERM_COLOR a, concptr s);
 
+/*!
+ * @brief 録画か配信をしているかを返す
+ */
+static bool is_streaming_frames()
+{
+    return movie_mode || chuukei_server;
+}
+
 static void disable_chuukei_server(void)
 {
     term_type *t = angband_terms[0];
@@ -107,12 +126,9 @@ static long get_current_time(void)
  */
 static errr insert_ringbuf(std::string_view header, std::string_view payload = "")
 {
-    if (movie_mode) {
-        fd_write(movie_fd, header.data(), header.length());
-        if (!payload.empty()) {
-            fd_write(movie_fd, payload.data(), payload.length());
-        }
-        fd_write(movie_fd, "", 1);
+    if (is_streaming_frames()) {
+        movie_frame.append(header);
+        movie_frame.append(payload);
         return 0;
     }
 
@@ -215,33 +231,37 @@ static int find_split(concptr str, int len)
 }
 #endif
 
-static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+/*!
+ * @brief 文字列の描画レコードを追加する
+ * @details 同じ文字の繰り返しは圧縮し、長い文字列は SPLIT_MAX 以下に分割する.
+ */
+static void insert_text(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
 {
     if (len == 1) {
-        insert_ringbuf(format("s%c%c%c%c", x + 1, y + 1, col, *str));
-        return (*old_text_hook)(x, y, len, col, str);
+        insert_ringbuf(make_movie_record('s', { x + 1, y + 1, col, *str }));
+        return;
     }
 
     if (string_is_repeat(str, len)) {
         while (len > SPLIT_MAX) {
-            insert_ringbuf(format("n%c%c%c%c%c", x + 1, y + 1, SPLIT_MAX, col, *str));
+            insert_ringbuf(make_movie_record('n', { x + 1, y + 1, SPLIT_MAX, col, *str }));
             x += SPLIT_MAX;
             len -= SPLIT_MAX;
         }
 
         std::string formatted_text;
         if (len > 1) {
-            formatted_text = format("n%c%c%c%c%c", x + 1, y + 1, len, col, *str);
+            formatted_text = make_movie_record('n', { x + 1, y + 1, len, col, *str });
         } else {
-            formatted_text = format("s%c%c%c%c", x + 1, y + 1, col, *str);
+            formatted_text = make_movie_record('s', { x + 1, y + 1, col, *str });
         }
 
         insert_ringbuf(formatted_text);
-        return (*old_text_hook)(x, y, len, col, str);
+        return;
     }
 
 #if defined(SJIS) && defined(JP)
-    std::string buffer = str; // strは書き換わって欲しくないのでコピーする.
+    std::string buffer(str, len); // strは書き換わって欲しくないのでコピーする.
     auto *payload = buffer.data();
     sjis2euc(payload);
 #else
@@ -249,24 +269,90 @@ static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_CO
 #endif
     while (len > SPLIT_MAX) {
         auto split_len = _(find_split(payload, SPLIT_MAX), SPLIT_MAX);
-        insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, split_len, col), std::string_view(payload, split_len));
+        insert_ringbuf(make_movie_record('t', { x + 1, y + 1, split_len, col }), std::string_view(payload, split_len));
         x += split_len;
         len -= split_len;
         payload += split_len;
     }
 
-    insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, len, col), std::string_view(payload, len));
+    insert_ringbuf(make_movie_record('t', { x + 1, y + 1, len, col }), std::string_view(payload, len));
+}
+
+/*!
+ * @brief 表示中の画面全体を描画レコードとして追加する
+ * @details 画面を消去してから、同じ色の文字の並びを1レコードずつ描く. 空白だけの並びは省く.
+ */
+static void insert_screen_image()
+{
+    const auto *term = angband_terms[0];
+    const auto &screen = *term->old;
+    insert_ringbuf(make_movie_record('x', { TERM_XTRA_CLEAR + 1 }));
+    for (TERM_LEN y = 0; y < term->hgt; y++) {
+        const auto &attrs = screen.a[y];
+        const auto &chars = screen.c[y];
+        TERM_LEN x = 0;
+        while (x < term->wid) {
+            auto end = x + 1;
+            while ((end < term->wid) && (attrs[end] == attrs[x])) {
+                end++;
+            }
+
+            const auto is_blank = std::all_of(&chars[x], &chars[x] + (end - x), [](char c) { return c == ' '; });
+            if (!is_blank) {
+                insert_text(x, y, end - x, attrs[x], &chars[x]);
+            }
+
+            x = end;
+        }
+    }
+
+    if (!screen.cu) {
+        insert_ringbuf(make_movie_record('c', { screen.cx + 1, screen.cy + 1 }));
+    }
+
+    insert_ringbuf(make_movie_record('x', { TERM_XTRA_FRESH + 1 }));
+}
+
+/*!
+ * @brief term_fresh() までの描画レコードを1フレームとして録画・配信する
+ * @details
+ * 一定時間毎に、差分の代わりに画面全体をキーフレームとして録画・配信する.
+ * 録画と配信のどちらかがキーフレームを必要とする時は、両方へ同じキーフレームを送る.
+ */
+static void record_movie_frame()
+{
+    const auto time = static_cast<uint32_t>(get_current_time() - epoch_time);
+    const auto is_keyframe = (movie_writer && movie_writer->is_keyframe_due(time)) || (chuukei_server && chuukei_server->is_keyframe_due(time));
+    if (is_keyframe) {
+        movie_frame.clear();
+        insert_screen_image();
+    }
+
+    if (movie_writer) {
+        movie_writer->write_frame(is_keyframe, time, movie_frame);
+    }
+
+    if (chuukei_server) {
+        chuukei_server->broadcast(is_keyframe, time, movie_frame);
+    }
+
+    movie_frame.clear();
+}
+
+static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+{
+    insert_text(x, y, len, col, str);
     return (*old_text_hook)(x, y, len, col, str);
 }
 
 static errr send_wipe_to_chuukei_server(int x, int y, int len)
 {
     while (len > SPLIT_MAX) {
-        insert_ringbuf(format("w%c%c%c", x + 1, y + 1, SPLIT_MAX));
+        insert_ringbuf(make_movie_record('w', { x + 1, y + 1, SPLIT_MAX }));
         x += SPLIT_MAX;
         len -= SPLIT_MAX;
     }
-    insert_ringbuf(format("w%c%c%c", x + 1, y + 1, len));
+    insert_ringbuf(make_movie_record('w', { x + 1, y + 1, len }));
 
     return (*old_wipe_hook)(x, y, len);
 }
@@ -274,13 +360,20 @@ static errr send_wipe_to_chuukei_server(int x, int y, int len)
 static errr send_xtra_to_chuukei_server(int n, int v)
 {
     if (n == TERM_XTRA_CLEAR || n == TERM_XTRA_FRESH || n == TERM_XTRA_SHAPE) {
-        insert_ringbuf(format("x%c", n + 1));
+        insert_ringbuf(make_movie_record('x', { n + 1 }));
 
-        if (n == TERM_XTRA_FRESH) {
+        if ((n == TERM_XTRA_FRESH) && is_streaming_frames()) {
+            record_movie_frame();
+        } else if (n == TERM_XTRA_FRESH) {
             insert_ringbuf("d", std::to_string(get_current_time() - epoch_time));
         }
     }
 
+    /* 入力待ちの間に録画データを書き出しておく */
+    if ((n == TERM_XTRA_EVENT) && v && movie_mode) {
+        movie_writer->flush();
+    }
+
     /* Verify the hook */
     if (!old_xtra_hook) {
         return -1;
@@ -291,14 +384,14 @@ static errr send_xtra_to_chuukei_server(int n, int v)
 
 static errr send_curs_to_chuukei_server(int x, int y)
 {
-    insert_ringbuf(format("c%c%c", x + 1, y + 1));
+    insert_ringbuf(make_movie_record('c', { x + 1, y + 1 }));
 
     return (*old_curs_hook)(x, y);
 }
 
 static errr send_bigcurs_to_chuukei_server(int x, int y)
 {
-    insert_ringbuf(format("C%c%c", x + 1, y + 1));
+    insert_ringbuf(make_movie_record('C', { x + 1, y + 1 }));
 
     return (*old_bigcurs_hook)(x, y);
 }
@@ -334,8 +427,11 @@ void prepare_movie_hooks(PlayerType *player_ptr)
 
     if (movie_mode) {
         movie_mode = 0;
-        disable_chuukei_server();
-        fd_close(movie_fd);
+        if (!chuukei_server) {
+            disable_chuukei_server();
+        }
+
+        movie_writer.reset();
         msg_print(_("録画を終了しました。", "Stopped recording."));
         return;
     }
@@ -366,16 +462,43 @@ void prepare_movie_hooks(PlayerType *player_ptr)
         movie_fd = fd_make(path);
     }
 
-    if (!movie_fd) {
+    if (movie_fd < 0) {
         msg_print(_("ファイルを開けません！", "Can not open file."));
         return;
     }
 
+    if (!chuukei_server) {
+        epoch_time = get_current_time();
+        prepare_chuukei_hooks();
+    }
+
     movie_mode = 1;
-    prepare_chuukei_hooks();
+    movie_writer = std::make_unique<MovieWriter>(movie_fd);
     do_cmd_redraw(player_ptr);
 }
 
+/*!
+ * @brief 画面の配信を開始する
+ * @param address 待ち受けるアドレス ("unix:<パス>" または "tcp:[<IPv4アドレス>:]<ポート>")
+ * @return 待ち受けを開始できたか否か
+ * @details 以後ゲームの終了まで、メインウィンドウの描画を接続してきた観戦者へ送る.
+ */
+bool start_chuukei_broadcast(std::string_view address)
+{
+    auto server = ChuukeiServer::listen(address);
+    if (!server) {
+        return false;
+    }
+
+    if (!movie_mode) {
+        epoch_time = get_current_time();
+        prepare_chuukei_hooks();
+    }
+
+    chuukei_server = std::move(server);
+    return true;
+}
+
 static int handle_movie_timestamp_data(int timestamp)
 {
     static int initialized = false;
@@ -517,6 +640,87 @@ static void update_term_size(int x, int y, int len)
     }
 }
 
+/*!
+ * @brief 描画レコードを1つ画面に描く
+ * @param buf 描画レコード (ヌル終端)
+ */
+static void draw_movie_record(char *buf)
+{
+    auto id = buf[0];
+    auto x = static_cast<uint8_t>(buf[1]) - 1;
+    auto y = static_cast<uint8_t>(buf[2]) - 1;
+    int len = static_cast<uint8_t>(buf[3]);
+    uint8_t col = buf[4];
+    char *mesg;
+    if (id == 's') {
+        col = buf[3];
+        mesg = &buf[4];
+    } else {
+        mesg = &buf[5];
+    }
+#ifndef WINDOWS
+    win2unix(col, mesg);
+#endif
+
+    switch (id) {
+    case 't': /* 通常 */
+#if defined(SJIS) && defined(JP)
+        euc2sjis(mesg);
+#endif
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
+        std::copy_n(mesg, len, &game_term->scr->c[y][x]);
+        for (auto i = x; i < x + len; i++) {
+            game_term->scr->a[y][i] = col;
+        }
+
+        break;
+    case 'n': /* 繰り返し */
+        for (auto i = 1; i < len + 1; i++) {
+            if (i == len) {
+                mesg[i] = '\0';
+                break;
+            }
+
+            mesg[i] = mesg[0];
+        }
+
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
+        std::copy_n(mesg, len, &game_term->scr->c[y][x]);
+        for (auto i = x; i < x + len; i++) {
+            game_term->scr->a[y][i] = col;
+        }
+
+        break;
+    case 's': /* 一文字 */
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->text_hook)(x, y, 1, (byte)col, mesg));
+        std::copy_n(&game_term->scr->c[y][x], 1, mesg);
+        game_term->scr->a[y][x] = col;
+        break;
+    case 'w':
+        update_term_size(x, y, len);
+        (void)((*angband_terms[0]->wipe_hook)(x, y, len));
+        break;
+    case 'x':
+        if (x == TERM_XTRA_CLEAR) {
+            term_clear();
+        }
+
+        (void)((*angband_terms[0]->xtra_hook)(x, 0));
+        break;
+    case 'c':
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->curs_hook)(x, y));
+        break;
+    case 'C':
+        update_term_size(x, y, 1);
+        (void)((*angband_terms[0]->bigcurs_hook)(x, y));
+        break;
+    }
+}
+
 static bool flush_ringbuf_client()
 {
     /* 書くデータなし */
@@ -532,86 +736,108 @@ static bool flush_ringbuf_client()
     /* 時間情報(区切り)が得られるまで書く */
     char buf[1024]{};
     while (get_nextbuf(buf)) {
-        auto id = buf[0];
-        auto x = static_cast<uint8_t>(buf[1]) - 1;
-        auto y = static_cast<uint8_t>(buf[2]) - 1;
-        int len = static_cast<uint8_t>(buf[3]);
-        uint8_t col = buf[4];
-        char *mesg;
-        if (id == 's') {
-            col = buf[3];
-            mesg = &buf[4];
-        } else {
-            mesg = &buf[5];
+        draw_movie_record(buf);
+    }
+
+    fresh_queue.next++;
+    if (fresh_queue.next == FRESH_QUEUE_SIZE) {
+        fresh_queue.next = 0;
+    }
+    return true;
+}
+
+/*!
+ * @brief 索引付きムービーの1フレームを画面に描く
+ * @param payload フレームの描画レコードの並び
+ */
+static void draw_movie_frame(std::string_view payload)
+{
+    char buf[1024]{};
+    while (!payload.empty()) {
+        const auto length = get_movie_record_length(payload);
+        if ((length == 0) || (length > payload.length())) {
+            return;
         }
-#ifndef WINDOWS
-        win2unix(col, mesg);
-#endif
 
-        switch (id) {
-        case 't': /* 通常 */
-#if defined(SJIS) && defined(JP)
-            euc2sjis(mesg);
-#endif
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
-            std::copy_n(mesg, len, &game_term->scr->c[y][x]);
-            for (auto i = x; i < x + len; i++) {
-                game_term->scr->a[y][i] = col;
-            }
+        std::copy_n(payload.begin(), length, buf);
+        buf[length] = '\0';
+        draw_movie_record(buf);
+        payload.remove_prefix(length);
+    }
+}
 
-            break;
-        case 'n': /* 繰り返し */
-            for (auto i = 1; i < len + 1; i++) {
-                if (i == len) {
-                    mesg[i] = '\0';
-                    break;
-                }
-
-                mesg[i] = mesg[0];
-            }
+/*!
+ * @brief 索引付きムービーを指定時刻まで待たずに描く
+ * @param reader ムービーファイル
+ * @param time 録画開始からの時刻
+ * @return 指定時刻より後の最初のフレーム
+ */
+static std::optional<MovieFrame> seek_indexed_movie(MovieReader &reader, uint32_t time)
+{
+    reader.seek(time);
+    auto frame = reader.read_frame();
+    while (frame && (frame->time <= time)) {
+        draw_movie_frame(frame->payload);
+        frame = reader.read_frame();
+    }
 
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->text_hook)(x, y, len, (byte)col, mesg));
-            std::copy_n(mesg, len, &game_term->scr->c[y][x]);
-            for (auto i = x; i < x + len; i++) {
-                game_term->scr->a[y][i] = col;
-            }
+    return frame;
+}
 
+/*!
+ * @brief 索引付きムービーを再生する
+ * @details
+ * 再生中は「+」「-」で早送り倍率を変え、「[」「]」で前後へ移動し、ESCで終了する.
+ * 移動先の直前のキーフレームから描き直すので、ファイルの長さに依らずすぐに移動できる.
+ */
+static void browse_indexed_movie()
+{
+    MovieReader reader(movie_fd);
+    auto frame = reader.read_frame();
+    auto speed = 1;
+    long origin_time = frame ? frame->time : 0; /* real_origin_time の時点での再生時刻 */
+    auto real_origin_time = get_current_time();
+    while (frame) {
+        const auto now = origin_time + (get_current_time() - real_origin_time) * speed;
+        if (frame->time <= now) {
+            draw_movie_frame(frame->payload);
+            frame = reader.read_frame();
+            continue;
+        }
+
+        char key;
+        if (term_inkey(&key, false, true) != 0) {
+#ifdef WINDOWS
+            Sleep(WAIT / speed);
+#else
+            usleep(WAIT / speed);
+#endif
+            continue;
+        }
+
+        origin_time = now;
+        real_origin_time = get_current_time();
+        switch (key) {
+        case '+':
+            speed = std::min(speed * 2, MAX_BROWSE_SPEED);
             break;
-        case 's': /* 一文字 */
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->text_hook)(x, y, 1, (byte)col, mesg));
-            std::copy_n(&game_term->scr->c[y][x], 1, mesg);
-            game_term->scr->a[y][x] = col;
-            break;
-        case 'w':
-            update_term_size(x, y, len);
-            (void)((*angband_terms[0]->wipe_hook)(x, y, len));
+        case '-':
+            speed = std::max(speed / 2, 1);
             break;
-        case 'x':
-            if (x == TERM_XTRA_CLEAR) {
-                term_clear();
-            }
-
-            (void)((*angband_terms[0]->xtra_hook)(x, 0));
+        case ']':
+            origin_time = now + BROWSE_SEEK_STEP;
+            frame = seek_indexed_movie(reader, static_cast<uint32_t>(origin_time));
             break;
-        case 'c':
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->curs_hook)(x, y));
+        case '[':
+            origin_time = std::max(now - BROWSE_SEEK_STEP, 0L);
+            frame = seek_indexed_movie(reader, static_cast<uint32_t>(origin_time));
             break;
-        case 'C':
-            update_term_size(x, y, 1);
-            (void)((*angband_terms[0]->bigcurs_hook)(x, y));
+        case ESCAPE:
+            return;
+        default:
             break;
         }
     }
-
-    fresh_queue.next++;
-    if (fresh_queue.next == FRESH_QUEUE_SIZE) {
-        fresh_queue.next = 0;
-    }
-    return true;
 }
 
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path)
@@ -626,6 +852,11 @@ void browse_movie(void)
     term_fresh();
     term_xtra(TERM_XTRA_REACT, 0);
 
+    if (MovieReader::is_indexed_movie(movie_fd)) {
+        browse_indexed_movie();
+        return;
+    }
+
     while (read_movie_file() == 0) {
         while (fresh_queue.next != fresh_queue.tail) {
             if (!flush_ringbuf_client()) {
@@ -7,6 +7,7 @@ class PlayerType;
 void prepare_movie_hooks(PlayerType *player_ptr);
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path);
 void browse_movie();
+bool start_chuukei_broadcast(std::string_view address);
 #ifndef WINDOWS
 void prepare_browse_movie_with_path_build(std::string_view filename);
 #endif
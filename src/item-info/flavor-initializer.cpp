@@ -9,16 +9,13 @@
 #include "system/angband-system.h"
 #include "system/baseitem/baseitem-definition.h"
 #include "system/baseitem/baseitem-list.h"
+#include "term/z-rand.h"
 
 /*!
  * @brief ゲーム開始時に行われるベースアイテムの初期化ルーチン
  */
 void initialize_items_flavor()
 {
-    auto &system = AngbandSystem::get_instance();
-    const Xoshiro128StarStar rng_backup = system.get_rng();
-    Xoshiro128StarStar flavor_rng(system.get_seed_flavor());
-    system.set_rng(flavor_rng);
     auto &baseitems = BaseitemList::get_instance();
     for (auto &baseitem : baseitems) {
         if (baseitem.flavor_name.empty()) {
@@ -28,8 +25,11 @@ void initialize_items_flavor()
         baseitem.flavor = baseitem.idx;
     }
 
-    baseitems.shuffle_flavors();
-    system.set_rng(rng_backup);
+    {
+        const RngStreamScope rng_scope(AngbandSystem::get_instance().get_seed_flavor());
+        baseitems.shuffle_flavors();
+    }
+
     for (auto &baseitem : baseitems) {
         if (!baseitem.is_valid()) {
             continue;
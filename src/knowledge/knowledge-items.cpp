@@ -140,6 +140,36 @@ static bool check_baseitem_chance(const BIT_FLAGS8 mode, const BaseitemDefinitio
     return sum_chances > 0;
 }
 
+/*!
+ * @brief グループに属するベースアイテムIDの一覧を返す
+ * @param grp_cur グループ種別
+ * @details 所属はゲーム中に変わらないので、初回に全グループ分の索引を作って使い回す.
+ */
+static const std::vector<short> &get_group_baseitem_ids(int grp_cur)
+{
+    static std::vector<std::vector<short>> group_index;
+    if (!group_index.empty()) {
+        return group_index[grp_cur];
+    }
+
+    group_index.resize(ITEM_KINDS_GROUP.size());
+    for (const auto &baseitem : BaseitemList::get_instance()) {
+        if (baseitem.name.empty()) {
+            continue;
+        }
+
+        for (size_t i = 0; i < ITEM_KINDS_GROUP.size(); i++) {
+            const auto group_tval = ITEM_KINDS_GROUP[i];
+            const auto is_member = (group_tval == ItemKindType::LIFE_BOOK) ? baseitem.bi_key.is_spell_book() : (baseitem.bi_key.tval() == group_tval);
+            if (is_member) {
+                group_index[i].push_back(baseitem.idx);
+            }
+        }
+    }
+
+    return group_index[grp_cur];
+}
+
 /*
  * Build a list of object indexes in the given group. Return the number
  * of objects in the group.
@@ -150,25 +180,13 @@ static bool check_baseitem_chance(const BIT_FLAGS8 mode, const BaseitemDefinitio
 static short collect_objects(int grp_cur, std::vector<short> &object_idx, BIT_FLAGS8 mode)
 {
     short object_cnt = 0;
-    const auto group_tval = ITEM_KINDS_GROUP[grp_cur];
-    for (const auto &baseitem : BaseitemList::get_instance()) {
-        if (baseitem.name.empty() || !check_baseitem_chance(mode, baseitem)) {
-            continue;
-        }
-
-        const auto tval = baseitem.bi_key.tval();
-        if (group_tval == ItemKindType::LIFE_BOOK) {
-            if (baseitem.bi_key.is_spell_book()) {
-                object_idx[object_cnt++] = baseitem.idx;
-            } else {
-                continue;
-            }
-        } else if (tval == group_tval) {
-            object_idx[object_cnt++] = baseitem.idx;
-        } else {
+    const auto &baseitems = BaseitemList::get_instance();
+    for (const auto bi_id : get_group_baseitem_ids(grp_cur)) {
+        if (!check_baseitem_chance(mode, baseitems.get_baseitem(bi_id))) {
             continue;
         }
 
+        object_idx[object_cnt++] = bi_id;
         if (mode & 0x01) {
             break;
         }
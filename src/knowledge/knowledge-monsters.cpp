@@ -40,6 +40,80 @@
 #include "view/display-monster-status.h"
 #include "world/world.h"
 
+namespace {
+/*!
+ * @brief モンスター種族がグループに属するかを返す
+ * @param group_char グループ名またはシンボル文字の一覧
+ * @param monrace_id モンスター種族ID
+ * @param monrace モンスター種族定義
+ */
+bool is_group_member(const std::string &group_char, MonraceId monrace_id, const MonraceDefinition &monrace)
+{
+    if (group_char == "Uniques") {
+        return monrace.kind_flags.has(MonsterKindType::UNIQUE);
+    }
+
+    if (group_char == "Riding") {
+        return monrace.misc_flags.has(MonsterMiscType::RIDING);
+    }
+
+    if (group_char == "Wanted") {
+        const auto &world = AngbandWorld::get_instance();
+        return (world.knows_daily_bounty && (world.today_mon == monrace_id)) || monrace.is_bounty(false);
+    }
+
+    if (group_char == "Amberites") {
+        return monrace.kind_flags.has(MonsterKindType::AMBERITE);
+    }
+
+    return angband_strchr(group_char.data(), monrace.symbol_definition.character) != nullptr;
+}
+
+/*!
+ * @brief グループに属するモンスター種族IDを表示順に並べて返す
+ * @param group_char グループ名またはシンボル文字の一覧
+ */
+std::vector<MonraceId> build_group_monrace_ids(const std::string &group_char)
+{
+    const auto &monraces = MonraceList::get_instance();
+    std::vector<MonraceId> monrace_ids;
+    for (const auto &[monrace_id, monrace] : monraces) {
+        if (is_group_member(group_char, monrace_id, monrace)) {
+            monrace_ids.push_back(monrace_id);
+        }
+    }
+
+    std::stable_sort(monrace_ids.begin(), monrace_ids.end(), [&monraces](auto x, auto y) { return monraces.order_level_unique(x, y); });
+    return monrace_ids;
+}
+
+/*!
+ * @brief グループに属するモンスター種族IDの一覧を返す
+ * @param grp_cur グループ種別
+ * @details
+ * 賞金首以外のグループの所属はゲーム中に変わらないので、初回に全グループ分の索引を作って使い回す.
+ * 賞金首はその日の賞金首によって変わるので、毎回作り直す.
+ */
+const std::vector<MonraceId> &get_group_monrace_ids(short grp_cur)
+{
+    static std::vector<std::vector<MonraceId>> group_index;
+    static std::vector<MonraceId> wanted_monrace_ids;
+    const auto &group_char = MONRACE_CHARACTERS_GROUP[grp_cur];
+    if (group_char == "Wanted") {
+        wanted_monrace_ids = build_group_monrace_ids(group_char);
+        return wanted_monrace_ids;
+    }
+
+    if (group_index.empty()) {
+        for (const auto &chars : MONRACE_CHARACTERS_GROUP) {
+            group_index.push_back((chars == "Wanted") ? std::vector<MonraceId>() : build_group_monrace_ids(chars));
+        }
+    }
+
+    return group_index[grp_cur];
+}
+}
+
 /*!
  * @brief 特定の与えられた条件に応じてモンスターのIDリストを作成する / Build a list of monster indexes in the given group.
  * @param player_ptr プレイヤーへの参照ポインタ
@@ -49,54 +123,21 @@
  */
 static std::vector<MonraceId> collect_monsters(short grp_cur, monster_lore_mode mode)
 {
-    const auto &group_char = MONRACE_CHARACTERS_GROUP[grp_cur];
-    const auto grp_unique = (MONRACE_CHARACTERS_GROUP[grp_cur] == "Uniques");
-    const auto grp_riding = (MONRACE_CHARACTERS_GROUP[grp_cur] == "Riding");
-    const auto grp_wanted = (MONRACE_CHARACTERS_GROUP[grp_cur] == "Wanted");
-    const auto grp_amberite = (MONRACE_CHARACTERS_GROUP[grp_cur] == "Amberites");
-
+    const auto is_all_shown = (mode == MONSTER_LORE_DEBUG) || (mode == MONSTER_LORE_RESEARCH) || cheat_know;
+    const auto is_existence_check = (mode == MONSTER_LORE_NORMAL) || (mode == MONSTER_LORE_DEBUG);
     const auto &monraces = MonraceList::get_instance();
     std::vector<MonraceId> monrace_ids;
-    for (const auto &[monrace_id, monrace] : monraces) {
-        if (((mode != MONSTER_LORE_DEBUG) && (mode != MONSTER_LORE_RESEARCH)) && !cheat_know && !monrace.r_sights) {
+    for (const auto monrace_id : get_group_monrace_ids(grp_cur)) {
+        if (!is_all_shown && !monraces.get_monrace(monrace_id).r_sights) {
             continue;
         }
 
-        if (grp_unique) {
-            if (monrace.kind_flags.has_not(MonsterKindType::UNIQUE)) {
-                continue;
-            }
-        } else if (grp_riding) {
-            if (monrace.misc_flags.has_not(MonsterMiscType::RIDING)) {
-                continue;
-            }
-        } else if (grp_wanted) {
-            const auto &world = AngbandWorld::get_instance();
-            auto wanted = world.knows_daily_bounty && (world.today_mon == monrace_id);
-            wanted |= monrace.is_bounty(false);
-            if (!wanted) {
-                continue;
-            }
-        } else if (grp_amberite) {
-            if (monrace.kind_flags.has_not(MonsterKindType::AMBERITE)) {
-                continue;
-            }
-        } else {
-            if (angband_strchr(group_char.data(), monrace.symbol_definition.character) == nullptr) {
-                continue;
-            }
-        }
-
         monrace_ids.push_back(monrace_id);
-        if (mode == MONSTER_LORE_NORMAL) {
-            break;
-        }
-        if (mode == MONSTER_LORE_DEBUG) {
+        if (is_existence_check) {
             break;
         }
     }
 
-    std::stable_sort(monrace_ids.begin(), monrace_ids.end(), [&monraces](auto x, auto y) { return monraces.order_level_unique(x, y); });
     return monrace_ids;
 }
 
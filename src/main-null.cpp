@@ -0,0 +1,268 @@
+/*!
+ * @brief 何も表示しない端末 (-mnull)
+ * @details
+ * 描画フックの呼び出しを捨てるか、メモリ上の簡潔なトレースに記録する.
+ * term_fresh() 毎に書き込まれたセル数・更新された行数・出力バイト数を集計し、終了時に標準出力へ書き出す.
+ * キー入力は標準入力から1バイトずつ読み、標準入力が尽きたら終了する.
+ * 画面の無い環境で redraw_stuff() / window_stuff() / term_fresh() の性能を計測するために使う.
+ *
+ * 出力バイト数はトレースの符号化サイズで数える. 記録しない時も同じ値になる.
+ * トレースの形式は以下の通り. 命令は1バイト、数値は全て2バイトのリトルエンディアン.
+ *   TEXT: 'T' x y n a 文字列(nバイト)
+ *   WIPE: 'W' x y n
+ *   CURS: 'C' x y
+ *   PICT: 'P' x y n (a c ta tc)×n
+ *   FRESH: 'F' (term_fresh() の区切り)
+ */
+
+#include "system/angband.h"
+#include "term/gameterm.h"
+#include "term/term-color-types.h"
+#include "term/z-form.h"
+#include "term/z-term.h"
+#include "term/z-util.h"
+#include "util/angband-files.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+constexpr auto MAX_NULL_TERMS = 8;
+
+/*!
+ * @brief term_fresh() 1回分、あるいはその累計の描画量
+ */
+struct NullTermFrame {
+    uint64_t cells = 0; //!< 書き込まれたセル数
+    uint64_t rows = 0; //!< 更新された行数
+    uint64_t bytes = 0; //!< 出力バイト数 (トレースの符号化サイズ)
+};
+
+/*!
+ * @brief 何も表示しない端末1枚分のデータ
+ */
+struct NullTermData {
+    term_type t;
+    int index = 0;
+    NullTermFrame frame; //!< 現在の term_fresh() で描画した量
+    NullTermFrame total; //!< 描画量の累計
+    NullTermFrame peak; //!< term_fresh() 1回当たりの最大値
+    uint64_t fresh_count = 0; //!< term_fresh() の回数
+};
+
+std::array<NullTermData, MAX_NULL_TERMS> data;
+auto num_terms = 1;
+auto is_recording = false;
+std::string trace_path;
+std::vector<uint8_t> trace;
+
+/*!
+ * @brief トレースに1件記録する
+ * @param td 端末データ
+ * @param command 命令
+ * @param args 命令の引数 (各2バイトで記録する)
+ * @param payload 引数に続くデータ (無ければ空)
+ */
+void record(NullTermData &td, char command, std::initializer_list<int> args = {}, std::string_view payload = {})
+{
+    td.frame.bytes += 1 + args.size() * 2 + payload.size();
+    if (!is_recording) {
+        return;
+    }
+
+    trace.push_back(static_cast<uint8_t>(command));
+    for (const auto arg : args) {
+        trace.push_back(static_cast<uint8_t>(arg & 0xFF));
+        trace.push_back(static_cast<uint8_t>((arg >> 8) & 0xFF));
+    }
+
+    trace.insert(trace.end(), payload.begin(), payload.end());
+}
+
+NullTermData &current_data()
+{
+    return *static_cast<NullTermData *>(game_term->data);
+}
+
+/*!
+ * @brief term_fresh() 1回分の描画量を累計に加える
+ */
+void finish_frame(NullTermData &td)
+{
+    record(td, 'F');
+    td.fresh_count++;
+    td.total.cells += td.frame.cells;
+    td.total.rows += td.frame.rows;
+    td.total.bytes += td.frame.bytes;
+    td.peak.cells = std::max(td.peak.cells, td.frame.cells);
+    td.peak.rows = std::max(td.peak.rows, td.frame.rows);
+    td.peak.bytes = std::max(td.peak.bytes, td.frame.bytes);
+    td.frame = {};
+}
+
+/*!
+ * @brief 標準入力から1キー読む
+ * @details 標準入力が尽きていたら、集計を書き出して終了する.
+ */
+errr game_term_xtra_null_event(int v)
+{
+    if (!v) {
+        return 0;
+    }
+
+    char ch;
+    if (read(STDIN_FILENO, &ch, 1) != 1) {
+        quit("");
+    }
+
+    term_key_push(static_cast<uint8_t>(ch));
+    return 0;
+}
+
+errr game_term_xtra_null(int n, int v)
+{
+    switch (n) {
+    case TERM_XTRA_EVENT:
+        return game_term_xtra_null_event(v);
+    case TERM_XTRA_FROSH:
+        current_data().frame.rows++;
+        return 0;
+    case TERM_XTRA_FRESH:
+        finish_frame(current_data());
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+errr game_term_curs_null(TERM_LEN x, TERM_LEN y)
+{
+    record(current_data(), 'C', { x, y });
+    return 0;
+}
+
+errr game_term_wipe_null(TERM_LEN x, TERM_LEN y, int n)
+{
+    auto &td = current_data();
+    td.frame.cells += n;
+    record(td, 'W', { x, y, n });
+    return 0;
+}
+
+errr game_term_text_null(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, concptr s)
+{
+    auto &td = current_data();
+    td.frame.cells += n;
+    record(td, 'T', { x, y, n, a }, std::string_view(s, n));
+    return 0;
+}
+
+errr game_term_pict_null(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *ap, concptr cp, const TERM_COLOR *tap, concptr tcp)
+{
+    auto &td = current_data();
+    td.frame.cells += n;
+    std::string cells;
+    for (auto i = 0; i < n; i++) {
+        cells.push_back(static_cast<char>(ap[i]));
+        cells.push_back(cp[i]);
+        cells.push_back(static_cast<char>(tap[i]));
+        cells.push_back(tcp[i]);
+    }
+
+    record(td, 'P', { x, y, n }, cells);
+    return 0;
+}
+
+/*!
+ * @brief 集計結果を標準出力に書き出し、トレースを保存する
+ */
+void hook_quit(std::string_view str)
+{
+    (void)str;
+    puts(format("%-6s %10s %14s %12s %14s %10s %10s %10s", "term", "fresh", "cells", "rows", "bytes", "cells/f", "rows/f", "bytes/f").data());
+    for (auto i = 0; i < num_terms; i++) {
+        const auto &td = data[i];
+        const auto count = std::max<uint64_t>(td.fresh_count, 1);
+        puts(format("%-6d %10llu %14llu %12llu %14llu %10.1f %10.1f %10.1f", td.index, static_cast<unsigned long long>(td.fresh_count),
+            static_cast<unsigned long long>(td.total.cells), static_cast<unsigned long long>(td.total.rows),
+            static_cast<unsigned long long>(td.total.bytes), static_cast<double>(td.total.cells) / count,
+            static_cast<double>(td.total.rows) / count, static_cast<double>(td.total.bytes) / count)
+                 .data());
+        puts(format("%-6s %10s %14llu %12llu %14llu", "  peak", "", static_cast<unsigned long long>(td.peak.cells),
+            static_cast<unsigned long long>(td.peak.rows), static_cast<unsigned long long>(td.peak.bytes))
+                 .data());
+    }
+
+    if (!is_recording) {
+        return;
+    }
+
+    auto *fff = angband_fopen(trace_path, FileOpenMode::WRITE, true);
+    if (fff == nullptr) {
+        plog_fmt("Cannot write the terminal trace '%s'.", trace_path.data());
+        return;
+    }
+
+    fwrite(trace.data(), 1, trace.size(), fff);
+    angband_fclose(fff);
+}
+
+void term_data_init(NullTermData &td, int index)
+{
+    auto *t = &td.t;
+    const auto cols = index == 0 ? MAIN_TERM_MIN_COLS : TERM_DEFAULT_COLS;
+    const auto rows = index == 0 ? MAIN_TERM_MIN_ROWS : TERM_DEFAULT_ROWS;
+    td.index = index;
+    term_init(t, cols, rows, 256);
+    t->attr_blank = TERM_WHITE;
+    t->char_blank = ' ';
+    t->text_hook = game_term_text_null;
+    t->wipe_hook = game_term_wipe_null;
+    t->curs_hook = game_term_curs_null;
+    t->pict_hook = game_term_pict_null;
+    t->xtra_hook = game_term_xtra_null;
+    t->data = &td;
+    term_activate(t);
+}
+}
+
+/*!
+ * @brief 何も表示しない端末を初期化する
+ * @details サブオプション -r<file> で描画トレースを記録して終了時に file へ書き出し、-n# で端末の枚数を指定する.
+ */
+errr init_null(int argc, char *argv[])
+{
+    for (auto i = 1; i < argc; i++) {
+        if (prefix(argv[i], "-r")) {
+            is_recording = true;
+            trace_path = &argv[i][2];
+            if (trace_path.empty()) {
+                quit("Specify the trace file after '-r'.");
+            }
+
+            continue;
+        }
+
+        if (prefix(argv[i], "-n")) {
+            num_terms = std::clamp(std::atoi(&argv[i][2]), 1, MAX_NULL_TERMS);
+            continue;
+        }
+
+        plog_fmt("Ignoring option: %s", argv[i]);
+    }
+
+    quit_aux = hook_quit;
+    for (auto i = 0; i < num_terms; i++) {
+        term_data_init(data[i], i);
+        angband_terms[i] = game_term;
+    }
+
+    term_activate(&data[0].t);
+    return 0;
+}
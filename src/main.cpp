@@ -26,6 +26,7 @@
 #include "util/angband-files.h"
 #include "util/string-processor.h"
 #include "view/display-scores.h"
+#include "wizard/headless-simulator.h"
 #include "wizard/spoiler-util.h"
 #include "wizard/wizard-spoiler.h"
 #include <filesystem>
@@ -179,8 +180,12 @@ static void display_usage(const char *program)
     puts("  -u<who>  Use your <who> savefile");
     puts("  -m<sys>  Force 'main-<sys>.c' usage");
     puts("  -d<def>  Define a 'lib' dir sub-path");
+    puts("  -c<addr> Broadcast the screen to spectators");
+    puts("           (<addr> is unix:<path> or tcp:[<host>:]<port>)");
     puts("  --output-spoilers");
     puts("           Output auto generated spoilers and exit");
+    puts("  --simulate[=<turns>[,<monsters>[,<seed>[,<level>]]]]");
+    puts("           Run monsters without display, report timings and exit");
     puts("");
 
 #ifdef USE_X11
@@ -205,6 +210,11 @@ static void display_usage(const char *program)
     puts("  -mcap    To use CAP (\"Termcap\" calls)");
 #endif /* USE_CAP */
 
+    puts("  -mnull   To use no display (keys are read from stdin)");
+    puts("  --       Sub options");
+    puts("  -- -r<file> Record the terminal output trace into <file>");
+    puts("  -- -n#   Number of terms to use");
+
     /* Actually abort the process */
     quit("");
 }
@@ -213,10 +223,25 @@ static void display_usage(const char *program)
  * @brief 2文字以上のコマンドライン引数 (オプション)を実行する
  * @param opt コマンドライン引数
  * @return Usageを表示する必要があるか否か
- * @details v3.0.0 Alpha21時点では、スポイラー出力モードの判定及び実行を行う
+ * @details スポイラー出力モードと画面無しシミュレーションの判定及び実行を行う
  */
 static bool parse_long_opt(const char *opt)
 {
+    constexpr std::string_view simulate_opt = "simulate";
+    const std::string_view long_opt(opt + 2);
+    if (long_opt.starts_with(simulate_opt)) {
+        const auto settings = parse_headless_simulation_settings(long_opt.substr(simulate_opt.length()));
+        if (!settings) {
+            return true;
+        }
+
+        init_stuff();
+        init_angband(p_ptr, true);
+        run_headless_simulation(p_ptr, *settings);
+        quit("");
+        return false;
+    }
+
     if (strcmp(opt + 2, "output-spoilers") != 0) {
         return true;
     }
@@ -286,6 +311,7 @@ int main(int argc, char *argv[])
 #endif /* SET_UID */
 
     auto browsing_movie = false;
+    std::string chuukei_address;
     for (auto i = 1; args && (i < argc); i++) {
         if (argv[i][0] != '-') {
             display_usage(argv[0]);
@@ -350,6 +376,15 @@ int main(int argc, char *argv[])
         case 'D':
             change_path(&argv[i][2]);
             break;
+        case 'c':
+        case 'C':
+            if (!argv[i][2]) {
+                is_usage_needed = true;
+                break;
+            }
+
+            chuukei_address = &argv[i][2];
+            break;
         case 'x':
             if (!argv[i][2]) {
                 is_usage_needed = true;
@@ -420,10 +455,22 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    if (!done && (mstr == "null")) {
+        extern errr init_null(int, char **);
+        if (0 == init_null(argc, argv)) {
+            ANGBAND_SYS = "null";
+            done = true;
+        }
+    }
+
     if (!done) {
         quit("Unable to prepare any 'display module'!");
     }
 
+    if (!chuukei_address.empty() && !start_chuukei_broadcast(chuukei_address)) {
+        quit_fmt("Unable to broadcast on '%s'!", chuukei_address.data());
+    }
+
     if (show_score > 0) {
         display_scores(0, show_score);
     }
@@ -22,6 +22,7 @@
 #include "main/game-data-initializer.h"
 #include "main/info-initializer.h"
 #include "market/building-initializer.h"
+#include "system/angband-exceptions.h"
 #include "system/angband-system.h"
 #include "system/dungeon/dungeon-definition.h"
 #include "system/monrace/monrace-definition.h"
@@ -32,7 +33,13 @@
 #include "term/term-color-types.h"
 #include "time.h"
 #include "util/angband-files.h"
+#include "util/task-graph.h"
+#include "view/display-messages.h"
 #include "world/world.h"
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
 
 /*!
  * @brief 各データファイルを読み取るためのパスを取得する.
@@ -170,45 +177,60 @@ void init_angband(PlayerType *player_ptr, bool no_term)
 
     void (*init_note)(concptr) = (no_term ? init_note_no_term : init_note_term);
 
-    init_note(_("[データの初期化中... (地形)]", "[Initializing arrays... (features)]"));
-    try {
+    // 互いに独立したゲームデータはワーカースレッドで並列に読み込む.
+    // 他のデータを参照する読み込み・補正処理は、依存先の読み込みが終わってから行う.
+    // ワーカースレッドで出たメッセージは溜めておき、全て終わってからメインスレッドで表示する.
+    init_note(_("[データの初期化中... (ゲームデータ)]", "[Initializing arrays... (game data)]"));
+    TaskGraph task_graph;
+    std::deque<std::vector<std::string>> task_messages;
+    const auto add_task = [&task_graph, &task_messages](std::string_view name, std::function<void()> func, std::initializer_list<std::string_view> dependencies = {}) {
+        auto &messages = task_messages.emplace_back();
+        task_graph.add(
+            name, [func = std::move(func), &messages] {
+                MessageDeferrer deferrer(messages);
+                func();
+            },
+            dependencies);
+    };
+    add_task("terrains", [] {
         init_terrains_info();
         init_feat_variables();
+    });
+    add_task("baseitems", init_baseitems_info);
+    add_task("artifacts", init_artifacts_info, { "baseitems" });
+    add_task("egos", init_egos_info);
+    add_task("monraces", init_monrace_definitions);
+    add_task("dungeons", init_dungeons_info, { "terrains", "monraces" });
+    add_task("spells", init_spell_info);
+    add_task("class_magics", init_class_magics_info, { "spells" });
+    add_task("class_skills", init_class_skills_info);
+    add_task("wilderness", init_wilderness);
+    add_task("vaults", init_vaults_info, { "terrains" });
+    std::optional<std::string> load_error;
+    try {
+        task_graph.run();
+    } catch (const GameDataLoadException &e) {
+        load_error = e.what();
     } catch (const std::exception &e) {
-        quit_fmt("地形初期化不能: %s", e.what());
+        load_error = format(_("ゲームデータ初期化不能: %s", "Cannot initialize game data: %s"), e.what());
     }
 
-    init_note(_("[データの初期化中... (アイテム)]", "[Initializing arrays... (objects)]"));
-    init_baseitems_info();
-
-    init_note(_("[データの初期化中... (伝説のアイテム)]", "[Initializing arrays... (artifacts)]"));
-    init_artifacts_info();
+    for (const auto &messages : task_messages) {
+        for (const auto &message : messages) {
+            msg_print(message);
+        }
+    }
 
-    init_note(_("[データの初期化中... (名のあるアイテム)]", "[Initializing arrays... (ego-items)]"));
-    init_egos_info();
+    if (load_error) {
+        msg_print(nullptr);
+        quit(*load_error);
+    }
 
-    init_note(_("[データの初期化中... (モンスター)]", "[Initializing arrays... (monsters)]"));
-    init_monrace_definitions();
     const auto error = BaseitemMonraceService::check_specific_drop_gold_flags_duplication();
     if (error) {
         quit(*error);
     }
 
-    init_note(_("[データの初期化中... (ダンジョン)]", "[Initializing arrays... (dungeon)]"));
-    init_dungeons_info();
-
-    init_note(_("[データの初期化中... (呪文情報)]", "[Initializing arrays... (magic)]"));
-    init_spell_info();
-
-    init_note(_("[データの初期化中... (魔法)]", "[Initializing arrays... (magic)]"));
-    init_class_magics_info();
-
-    init_note(_("[データの初期化中... (熟練度)]", "[Initializing arrays... (skill)]"));
-    init_class_skills_info();
-
-    init_note(_("[配列を初期化しています... (荒野)]", "[Initializing arrays... (wilderness)]"));
-    init_wilderness();
-
     init_note(_("[配列を初期化しています... (街)]", "[Initializing arrays... (towns)]"));
     init_towns();
 
@@ -218,9 +240,6 @@ void init_angband(PlayerType *player_ptr, bool no_term)
     init_note(_("[配列を初期化しています... (クエスト)]", "[Initializing arrays... (quests)]"));
     QuestList::get_instance().initialize();
 
-    init_note(_("[データの初期化中... (宝物庫)]", "[Initializing arrays... (vaults)]"));
-    init_vaults_info();
-
     init_note(_("[データの初期化中... (その他)]", "[Initializing arrays... (other)]"));
     init_other(player_ptr);
 
@@ -0,0 +1,248 @@
+/*!
+ * @file info-cache.cpp
+ * @brief ゲームデータ(JSON)の解析結果キャッシュ
+ * @details
+ * lib/edit/ の .jsonc ファイルから読み込んだ各レコードを、MessagePack形式で lib/data/ にキャッシュする.
+ * キャッシュは元ファイルのハッシュ値をキーとし、元ファイルが変更されていれば使用しない.
+ * キャッシュが無い・壊れている・書き込めない場合は常に元ファイルの解析にフォールバックする.
+ *
+ * ファイルフォーマット (整数はリトルエンディアン)
+ * - マジックナンバー "HBIC" (4バイト)
+ * - フォーマットバージョン (4バイト)
+ * - 元ファイルのハッシュ値 (32バイト)
+ * - レコード部のハッシュ値 (32バイト)
+ * - レコード数 (4バイト)
+ * - レコード部のバイト数 (8バイト)
+ * - レコード部: レコード数だけ以下を繰り返す
+ *   - MessagePackデータのバイト数 (4バイト)
+ *   - MessagePackデータ
+ */
+
+#include "main/info-cache.h"
+#include "io/files-util.h"
+#include "io/uid-checker.h"
+#include "util/angband-files.h"
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::string_view CACHE_MAGIC = "HBIC";
+constexpr uint32_t CACHE_FORMAT_VERSION = 2;
+constexpr auto CACHE_HEADER_SIZE = CACHE_MAGIC.size() + sizeof(uint32_t) + util::SHA256::DIGEST_SIZE * 2 + sizeof(uint32_t) + sizeof(uint64_t);
+
+/*!
+ * @brief 権限の取得から解放までを排他するためのミューテックス
+ * @details 実効ユーザIDはプロセス全体で共有されるので、並列に読み込んでいる他のファイルが途中で権限を手放さないようにする.
+ */
+std::mutex setuid_mutex;
+
+std::filesystem::path get_cache_path(std::string_view filename)
+{
+    auto cache_filename = std::filesystem::path(filename).stem().string();
+    cache_filename.append(".raw");
+    return path_build(ANGBAND_DIR_DATA, cache_filename);
+}
+
+template <typename T>
+void write_le(std::ostream &os, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        os.put(static_cast<char>(static_cast<uint8_t>(value >> (8 * i))));
+    }
+}
+
+template <typename T>
+T read_le(const uint8_t *ptr)
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(ptr[i]) << (8 * i);
+    }
+
+    return value;
+}
+}
+
+/*!
+ * @brief キャッシュからゲームデータを1レコードずつ読み込む
+ * @details レコードを1つも処理しないうちにキャッシュ全体の整合性を検証するので、
+ * falseが返った時は record_handler は一度も呼ばれていない.
+ * @param filename 元ファイル名 (lib/edit/ からの相対パス)
+ * @param source_digest 元ファイルの内容のハッシュ値
+ * @param record_handler 読み込んだレコードを処理する関数
+ * @return キャッシュが有効で全レコードを処理したらtrue、キャッシュが無効ならfalse
+ */
+bool load_info_cache(std::string_view filename, const util::SHA256::Digest &source_digest, const std::function<void(nlohmann::json &)> &record_handler)
+{
+    std::ifstream ifs(get_cache_path(filename), std::ios::binary);
+    if (!ifs) {
+        return false;
+    }
+
+    const std::vector<uint8_t> buf{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+    if (buf.size() < CACHE_HEADER_SIZE) {
+        return false;
+    }
+
+    const auto *ptr = buf.data();
+    if (std::memcmp(ptr, CACHE_MAGIC.data(), CACHE_MAGIC.size()) != 0) {
+        return false;
+    }
+    ptr += CACHE_MAGIC.size();
+
+    if (read_le<uint32_t>(ptr) != CACHE_FORMAT_VERSION) {
+        return false;
+    }
+    ptr += sizeof(uint32_t);
+
+    if (std::memcmp(ptr, source_digest.data(), source_digest.size()) != 0) {
+        return false;
+    }
+    ptr += source_digest.size();
+
+    const auto *payload_digest = ptr;
+    ptr += util::SHA256::DIGEST_SIZE;
+
+    const auto record_count = read_le<uint32_t>(ptr);
+    ptr += sizeof(uint32_t);
+
+    const auto payload_size = read_le<uint64_t>(ptr);
+    ptr += sizeof(uint64_t);
+    if (payload_size != buf.size() - CACHE_HEADER_SIZE) {
+        return false;
+    }
+
+    const auto *end = buf.data() + buf.size();
+    util::SHA256 payload_sha256;
+    payload_sha256.update(std::as_bytes(std::span(ptr, end)).data(), payload_size);
+    if (std::memcmp(payload_sha256.digest().data(), payload_digest, util::SHA256::DIGEST_SIZE) != 0) {
+        return false;
+    }
+
+    auto *record_ptr = ptr;
+    for (auto i = 0U; i < record_count; ++i) {
+        if (end - record_ptr < static_cast<std::ptrdiff_t>(sizeof(uint32_t))) {
+            return false;
+        }
+
+        const auto record_size = read_le<uint32_t>(record_ptr);
+        record_ptr += sizeof(uint32_t) + record_size;
+        if (record_ptr > end) {
+            return false;
+        }
+    }
+
+    if (record_ptr != end) {
+        return false;
+    }
+
+    for (auto i = 0U; i < record_count; ++i) {
+        const auto record_size = read_le<uint32_t>(ptr);
+        ptr += sizeof(uint32_t);
+        auto record = nlohmann::json::from_msgpack(ptr, ptr + record_size);
+        ptr += record_size;
+        record_handler(record);
+    }
+
+    return true;
+}
+
+/*!
+ * @brief コンストラクタ
+ * @param filename 元ファイル名 (lib/edit/ からの相対パス)
+ * @param source_digest 元ファイルの内容のハッシュ値
+ */
+InfoCacheWriter::InfoCacheWriter(std::string_view filename, const util::SHA256::Digest &source_digest)
+    : path(get_cache_path(filename))
+    , source_digest(source_digest)
+{
+    this->tmp_path = this->path;
+    this->tmp_path += '.' + std::to_string(std::random_device()()) + ".tmp";
+
+    const std::lock_guard lock(setuid_mutex);
+    safe_setuid_grab();
+    this->ofs.open(this->tmp_path, std::ios::binary | std::ios::trunc);
+    safe_setuid_drop();
+
+    this->write_header({});
+}
+
+InfoCacheWriter::~InfoCacheWriter()
+{
+    if (this->is_committed) {
+        return;
+    }
+
+    if (this->ofs.is_open()) {
+        this->ofs.close();
+    }
+
+    const std::lock_guard lock(setuid_mutex);
+    safe_setuid_grab();
+    fd_kill(this->tmp_path);
+    safe_setuid_drop();
+}
+
+/*!
+ * @brief レコードを1つ追加する
+ * @param record 追加するレコード
+ */
+void InfoCacheWriter::add(const nlohmann::json &record)
+{
+    if (!this->ofs) {
+        return;
+    }
+
+    const auto msgpack = nlohmann::json::to_msgpack(record);
+    const auto record_size = static_cast<uint32_t>(msgpack.size());
+    std::array<uint8_t, sizeof(uint32_t)> size_bytes{};
+    for (size_t i = 0; i < size_bytes.size(); ++i) {
+        size_bytes[i] = static_cast<uint8_t>(record_size >> (8 * i));
+    }
+
+    this->payload_sha256.update(std::as_bytes(std::span(size_bytes)).data(), size_bytes.size());
+    this->payload_sha256.update(std::as_bytes(std::span(msgpack)).data(), msgpack.size());
+    this->ofs.write(reinterpret_cast<const char *>(size_bytes.data()), size_bytes.size());
+    this->ofs.write(reinterpret_cast<const char *>(msgpack.data()), msgpack.size());
+    this->record_count++;
+    this->payload_size += size_bytes.size() + msgpack.size();
+}
+
+/*!
+ * @brief ヘッダを確定させてキャッシュファイルを置き換える
+ * @details 書き込みに失敗していた場合は何もしない (次回起動時も元ファイルを解析するだけである).
+ */
+void InfoCacheWriter::commit()
+{
+    if (!this->ofs) {
+        return;
+    }
+
+    this->ofs.seekp(0);
+    this->write_header(this->payload_sha256.digest());
+    this->ofs.close();
+    if (this->ofs.fail()) {
+        return;
+    }
+
+    const std::lock_guard lock(setuid_mutex);
+    safe_setuid_grab();
+    fd_move(this->tmp_path, this->path);
+    safe_setuid_drop();
+    this->is_committed = true;
+}
+
+void InfoCacheWriter::write_header(const util::SHA256::Digest &payload_digest)
+{
+    this->ofs.write(CACHE_MAGIC.data(), CACHE_MAGIC.size());
+    write_le(this->ofs, CACHE_FORMAT_VERSION);
+    this->ofs.write(reinterpret_cast<const char *>(this->source_digest.data()), this->source_digest.size());
+    this->ofs.write(reinterpret_cast<const char *>(payload_digest.data()), payload_digest.size());
+    write_le(this->ofs, this->record_count);
+    write_le(this->ofs, this->payload_size);
+}
@@ -0,0 +1,45 @@
+#pragma once
+/*!
+ * @file info-cache.h
+ * @brief ゲームデータ(JSON)の解析結果キャッシュヘッダ
+ */
+
+#include "external-lib/include-json.h"
+#include "util/sha256.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string_view>
+
+bool load_info_cache(std::string_view filename, const util::SHA256::Digest &source_digest, const std::function<void(nlohmann::json &)> &record_handler);
+
+/*!
+ * @brief ゲームデータのキャッシュを1レコードずつ書き込むクラス
+ * @details 一時ファイルに書き込み、commit() で本来のキャッシュファイルに置き換える.
+ * commit() せずに破棄された場合は一時ファイルを削除する.
+ */
+class InfoCacheWriter {
+public:
+    InfoCacheWriter(std::string_view filename, const util::SHA256::Digest &source_digest);
+    ~InfoCacheWriter();
+    InfoCacheWriter(const InfoCacheWriter &) = delete;
+    InfoCacheWriter &operator=(const InfoCacheWriter &) = delete;
+    InfoCacheWriter(InfoCacheWriter &&) = delete;
+    InfoCacheWriter &operator=(InfoCacheWriter &&) = delete;
+
+    void add(const nlohmann::json &record);
+    void commit();
+
+private:
+    std::filesystem::path path;
+    std::filesystem::path tmp_path;
+    std::ofstream ofs;
+    util::SHA256::Digest source_digest;
+    util::SHA256 payload_sha256;
+    uint32_t record_count = 0;
+    uint64_t payload_size = 0;
+    bool is_committed = false;
+
+    void write_header(const util::SHA256::Digest &payload_digest);
+};
@@ -21,11 +21,13 @@
 #include "io/files-util.h"
 #include "io/uid-checker.h"
 #include "main/angband-headers.h"
+#include "main/info-cache.h"
 #include "main/init-error-messages-table.h"
 #include "object-enchant/object-ego.h"
 #include "player-info/class-info.h"
 #include "player/player-skill.h"
 #include "room/rooms-vault.h"
+#include "system/angband-exceptions.h"
 #include "system/angband-version.h"
 #include "system/artifact-type-definition.h"
 #include "system/baseitem/baseitem-definition.h"
@@ -44,6 +46,7 @@
 #include "world/world.h"
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <sys/stat.h>
@@ -89,7 +92,7 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
     const auto path = path_build(ANGBAND_DIR_EDIT, filename);
     auto *fp = angband_fopen(path, FileOpenMode::READ);
     if (!fp) {
-        quit_fmt(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data());
+        throw GameDataLoadException(format(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data()));
     }
 
     char buf[1024]{};
@@ -104,8 +107,7 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
 #endif
         msg_format(_("レコード %d は '%s' エラーがあります。", "Record %d contains a '%s' error."), error_idx, oops);
         msg_format(_("構文 '%s'。", "Parsing '%s'."), buf);
-        msg_print(nullptr);
-        quit_fmt(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data());
+        throw GameDataLoadException(format(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data()));
     }
 
     if constexpr (HasShrinkToFit<InfoType>) {
@@ -121,8 +123,13 @@ static void init_info(std::string_view filename, angband_header &head, InfoType
  * @brief 各種設定データをlib/edit/.jsoncから読み込み
  * Load data from lib/edit/.jsonc
  * @param filename ファイル名(拡張子jsonc)
+ * @param keyname レコードの配列を持つキー名
  * @param head 処理に用いるヘッダ構造体
  * @param info データ保管先の構造体ポインタ
+ * @details
+ * ファイル全体をDOMに展開せず、keynameの配列の要素を1つ解析し終える毎にparserへ渡して破棄する.
+ * 読み込んだレコードは lib/data/ にキャッシュし、元ファイルが変更されるまで再利用する.
+ * キャッシュの照合には元ファイルのバイト列のハッシュ値を使い、head の digest にはレコードを正規化したもののハッシュ値を使う.
  * @note
  * Note that we let each entry have a unique "name" and "text" string,
  * even if the string happens to be empty (everyone has a unique '\0').
@@ -131,29 +138,56 @@ template <typename InfoType>
 static void init_json(std::string_view filename, std::string_view keyname, angband_header &head, InfoType &info, JSONParser parser)
 {
     const auto path = path_build(ANGBAND_DIR_EDIT, filename);
-    std::ifstream ifs(path);
+    std::ifstream ifs(path, std::ios::binary);
 
     if (!ifs) {
-        quit_fmt(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data());
+        throw GameDataLoadException(format(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), filename.data()));
     }
 
-    std::istreambuf_iterator<char> ifs_iter(ifs);
-    std::istreambuf_iterator<char> ifs_end;
-    auto json_object = nlohmann::json::parse(ifs_iter, ifs_end, nullptr, true, true);
+    const std::string source{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+    util::SHA256 source_sha256;
+    source_sha256.update(source);
+    const auto source_digest = source_sha256.digest();
 
     error_idx = -1;
 
-    for (auto &element : json_object[keyname]) {
+    // 改行コードやコメント・空白の違いに左右されないよう、ヘッダのハッシュ値は正規化したレコードから求める
+    util::SHA256 records_sha256;
+    auto parse_record = [&](nlohmann::json &element) {
+        records_sha256.update(element.dump());
         const auto error_code = parser(element, &head);
         if (error_code != PARSE_ERROR_NONE) {
-            msg_print(nullptr);
-            quit_fmt(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data());
+            throw GameDataLoadException(format(_("'%s'ファイルにエラー", "Error in '%s' file."), filename.data()));
         }
+    };
+
+    // 元ファイルが前回から変更されていなければ、キャッシュ済みのレコードを使う
+    if (!load_info_cache(filename, source_digest, parse_record)) {
+        InfoCacheWriter cache_writer(filename, source_digest);
+        auto is_in_records = false;
+        auto callback = [&](int depth, nlohmann::json::parse_event_t event, nlohmann::json &parsed) {
+            using Event = nlohmann::json::parse_event_t;
+            if ((depth == 1) && (event == Event::key)) {
+                is_in_records = parsed == keyname;
+                return true;
+            }
+
+            const auto is_record_end = (event == Event::object_end) || (event == Event::array_end) || (event == Event::value);
+            if (!is_in_records || (depth != 2) || !is_record_end) {
+                return true;
+            }
+
+            cache_writer.add(parsed);
+            parse_record(parsed);
+            return false;
+        };
+
+        // 戻り値にはレコード以外の要素 (バージョン番号等) だけが残る
+        const auto json_header = nlohmann::json::parse(source, callback, true, true);
+        cache_writer.commit();
     }
 
-    util::SHA256 sha256;
-    sha256.update(json_object.dump());
-    head.digest = sha256.digest();
+    head.digest = records_sha256.digest();
 
     if constexpr (HasShrinkToFit<InfoType>) {
         info.shrink_to_fit();
@@ -306,10 +340,10 @@ void init_wilderness()
     const auto path = path_build(ANGBAND_DIR_EDIT, WILDERNESS_DEFINITION);
     std::ifstream ifs(path);
     if (!ifs) {
-        quit_fmt(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), WILDERNESS_DEFINITION);
+        throw GameDataLoadException(format(_("'%s'ファイルをオープンできません。", "Cannot open '%s' file."), WILDERNESS_DEFINITION));
     }
 
     if (!read_wilderness_definition(ifs)) {
-        quit(_("荒野を初期化できません", "Cannot initialize wilderness"));
+        throw GameDataLoadException(_("荒野を初期化できません", "Cannot initialize wilderness"));
     }
 }
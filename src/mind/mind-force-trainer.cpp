@@ -246,6 +246,7 @@ bool shock_power(PlayerType *player_ptr)
     floor.get_grid(pos_target).m_idx = m_idx;
     monster.fy = pos_target.y;
     monster.fx = pos_target.x;
+    floor.spatial_index.update_monster(m_idx, pos_target);
 
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, pos_origin.y, pos_origin.x);
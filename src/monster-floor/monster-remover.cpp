@@ -81,6 +81,8 @@ void delete_monster_idx(PlayerType *player_ptr, MONSTER_IDX i)
     }
 
     floor_ptr->grid_array[y][x].m_idx = 0;
+    floor_ptr->spatial_index.remove_monster(i);
+    floor_ptr->monster_turn_states.remove(i);
     for (auto it = m_ptr->hold_o_idx_list.begin(); it != m_ptr->hold_o_idx_list.end();) {
         const OBJECT_IDX this_o_idx = *it++;
         delete_object_idx(player_ptr, this_o_idx);
@@ -97,6 +99,7 @@ void delete_monster_idx(PlayerType *player_ptr, MONSTER_IDX i)
 
     *m_ptr = {};
     floor_ptr->m_cnt--;
+    floor_ptr->release_monster_index(i);
     lite_spot(player_ptr, y, x);
     if (r_ptr->brightness_flags.has_any_of(ld_mask)) {
         RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::MONSTER_LITE);
@@ -120,12 +123,15 @@ void wipe_monsters_list(PlayerType *player_ptr)
         }
 
         floor.grid_array[monster.fy][monster.fx].m_idx = 0;
+        floor.spatial_index.remove_monster(i);
+        floor.monster_turn_states.remove(i);
         monster = {};
     }
 
     monraces.reset_current_numbers();
     floor.m_max = 1;
     floor.m_cnt = 0;
+    floor.clear_released_monster_indices();
     floor.reset_mproc_max();
     floor.num_repro = 0;
     target_who = 0;
@@ -328,12 +328,14 @@ std::optional<MONSTER_IDX> place_monster_one(PlayerType *player_ptr, POSITION y,
     monster.fy = pos.y;
     monster.fx = pos.x;
     monster.current_floor_ptr = &floor;
+    floor.spatial_index.update_monster(m_idx, pos);
 
     for (const auto mte : MONSTER_TIMED_EFFECT_RANGE) {
         monster.mtimed[mte] = 0;
     }
 
     monster.cdis = 0;
+    floor.monster_turn_states.update(m_idx, monster);
     monster.reset_target();
     monster.nickname.clear();
     monster.exp = 0;
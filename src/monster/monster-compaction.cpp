@@ -16,12 +16,14 @@
 #include "tracking/health-bar-tracker.h"
 #include "view/display-messages.h"
 #include <utility>
+#include <vector>
 
 /*!
  * @brief モンスター情報を配列内移動する / Move an object from index i1 to index i2 in the object list
  * @param player_ptr プレイヤーへの参照ポインタ
  * @param i1 配列移動元添字
  * @param i2 配列移動先添字
+ * @details 他のモンスターや時限ステータスリストが持つ添字は relocate_monster_references() でまとめて付け替える.
  */
 static void compact_monsters_aux(PlayerType *player_ptr, MONSTER_IDX i1, MONSTER_IDX i2)
 {
@@ -62,22 +64,38 @@ static void compact_monsters_aux(PlayerType *player_ptr, MONSTER_IDX i1, MONSTER
         health_track(player_ptr, i2);
     }
 
-    if (monster.is_pet()) {
-        for (int i = 1; i < floor.m_max; i++) {
-            MonsterEntity *m2_ptr = &floor.m_list[i];
+    floor.m_list[i2] = std::exchange(floor.m_list[i1], {});
+    floor.spatial_index.remove_monster(i1);
+    floor.spatial_index.update_monster(i2, floor.m_list[i2].get_position());
+    floor.monster_turn_states.remove(i1);
+    floor.monster_turn_states.update(i2, floor.m_list[i2]);
+}
 
-            if (m2_ptr->parent_m_idx == i1) {
-                m2_ptr->parent_m_idx = i2;
-            }
+/*!
+ * @brief 配列を詰め直した後、モンスター同士の親子関係と時限ステータスリストの添字を付け替える
+ * @param floor フロアへの参照
+ * @param relocations 移動前の添字から移動後の添字への対応表 (削除済のモンスターは0)
+ * @details 親子関係はペットの召喚主の時だけ付け替える (1体ずつ移動していた頃と同じ).
+ */
+static void relocate_monster_references(FloorType &floor, const std::vector<MONSTER_IDX> &relocations)
+{
+    const auto relocate = [&relocations](MONSTER_IDX m_idx) {
+        const auto is_relocated = (m_idx > 0) && std::cmp_less(m_idx, relocations.size()) && (relocations[m_idx] > 0);
+        return is_relocated ? relocations[m_idx] : m_idx;
+    };
+
+    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+        auto &monster = floor.m_list[i];
+        const auto parent_m_idx = relocate(monster.parent_m_idx);
+        if ((parent_m_idx != monster.parent_m_idx) && floor.m_list[parent_m_idx].is_pet()) {
+            monster.parent_m_idx = parent_m_idx;
         }
     }
 
-    floor.m_list[i2] = std::exchange(floor.m_list[i1], {});
-
     for (const auto mte : MONSTER_TIMED_EFFECT_RANGE) {
-        const auto index = floor.get_mproc_index(i1, mte);
-        if (index >= 0) {
-            floor.mproc_list[mte][*index] = i2;
+        auto &mproc_list = floor.mproc_list[mte];
+        for (auto i = 0; i < floor.mproc_max[mte]; i++) {
+            mproc_list[i] = relocate(mproc_list[i]);
         }
     }
 }
@@ -146,14 +164,22 @@ void compact_monsters(PlayerType *player_ptr, int size)
         }
     }
 
-    /* Excise dead monsters (backwards!) */
-    for (MONSTER_IDX i = floor.m_max - 1; i >= 1; i--) {
-        const auto &monster = floor.m_list[i];
-        if (monster.is_valid()) {
-            continue;
+    /* Excise dead monsters, keeping the order of live ones */
+    std::vector<MONSTER_IDX> relocations(floor.m_max, 0);
+    MONSTER_IDX m_max = 1;
+    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+        if (floor.m_list[i].is_valid()) {
+            relocations[i] = m_max++;
         }
+    }
 
-        compact_monsters_aux(player_ptr, floor.m_max - 1, i);
-        floor.m_max--;
+    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+        if (relocations[i] > 0) {
+            compact_monsters_aux(player_ptr, i, relocations[i]);
+        }
     }
+
+    floor.m_max = m_max;
+    relocate_monster_references(floor, relocations);
+    floor.clear_released_monster_indices();
 }
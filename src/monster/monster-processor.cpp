@@ -69,6 +69,8 @@
 #include "tracking/lore-tracker.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
+#include <vector>
 
 void decide_drop_from_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool is_riding_mon);
 bool process_stealth(PlayerType *player_ptr, MONSTER_IDX m_idx);
@@ -628,6 +630,7 @@ void process_monsters(PlayerType *player_ptr)
     OldRaceFlags flags(old_monrace_id);
     player_ptr->current_floor_ptr->monster_noise = false;
     sweep_monster_process(player_ptr);
+    player_ptr->current_floor_ptr->recycle_held_monster_indices();
     if (!tracker.is_tracking() || !tracker.is_tracking(old_monrace_id)) {
         return;
     }
@@ -642,28 +645,28 @@ void process_monsters(PlayerType *player_ptr)
 void sweep_monster_process(PlayerType *player_ptr)
 {
     auto &floor = *player_ptr->current_floor_ptr;
+    const auto &turn_states = floor.monster_turn_states;
 
     // 処理中の召喚などで生成されたモンスターが即座に行動しないようにするため、
     // 先に現在存在するモンスターをリストアップしておく
-    std::vector<MONSTER_IDX> valid_m_idx_list;
-    for (MONSTER_IDX m_idx = floor.m_max - 1; m_idx >= 1; m_idx--) {
-        if (floor.m_list[m_idx].is_valid()) {
-            valid_m_idx_list.push_back(m_idx);
-        }
-    }
+    const auto valid_m_idx_list = turn_states.collect_valid_indices(floor.m_max);
 
     for (const auto m_idx : valid_m_idx_list) {
-        auto *m_ptr = &floor.m_list[m_idx];
-
         if (player_ptr->leaving) {
             return;
         }
 
-        if (!m_ptr->is_valid() || AngbandWorld::get_instance().is_wild_mode()) {
+        // 感知範囲外のモンスターは MonsterEntity を参照せずに読み飛ばす
+        if (!turn_states.is_valid(m_idx) || AngbandWorld::get_instance().is_wild_mode()) {
             continue;
         }
 
-        if ((m_ptr->cdis >= MAX_MONSTER_SENSING) || !decide_process_continue(player_ptr, m_ptr)) {
+        if (!turn_states.is_in_sensing_range(m_idx)) {
+            continue;
+        }
+
+        auto *m_ptr = &floor.m_list[m_idx];
+        if (!decide_process_continue(player_ptr, m_ptr)) {
             continue;
         }
 
@@ -686,6 +689,74 @@ void sweep_monster_process(PlayerType *player_ptr)
     }
 }
 
+/*!
+ * @brief 次のゲームターンの sweep_monster_process() で行動エネルギーを得るモンスターを列挙する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return モンスターIDのリスト
+ */
+static std::vector<short> collect_energy_gaining_monsters(PlayerType *player_ptr)
+{
+    if (AngbandWorld::get_instance().is_wild_mode()) {
+        return {};
+    }
+
+    auto &floor = *player_ptr->current_floor_ptr;
+    const auto &turn_states = floor.monster_turn_states;
+    std::vector<short> m_idx_list;
+    for (const auto m_idx : turn_states.collect_valid_indices(floor.m_max)) {
+        if (!turn_states.is_in_sensing_range(m_idx)) {
+            continue;
+        }
+
+        if (decide_process_continue(player_ptr, &floor.m_list[m_idx])) {
+            m_idx_list.push_back(m_idx);
+        }
+    }
+
+    return m_idx_list;
+}
+
+static byte get_monster_speed(PlayerType *player_ptr, const MonsterEntity &monster)
+{
+    return monster.is_riding() ? player_ptr->pspeed : monster.get_temporary_speed();
+}
+
+/*!
+ * @brief どのモンスターも行動しないまま経過するゲームターン数を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param max_turns 数えるゲームターン数の上限
+ * @return sweep_monster_process() が行動エネルギーを減らすだけで終わるゲームターン数 (max_turns以下)
+ * @details 行動エネルギーを得るかどうかはプレイヤーもモンスターも動かない限り変わらないので、今の状態から求められる.
+ */
+int count_monster_idle_turns(PlayerType *player_ptr, int max_turns)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    auto idle_turns = max_turns;
+    for (const auto m_idx : collect_energy_gaining_monsters(player_ptr)) {
+        const auto &monster = floor.m_list[m_idx];
+        idle_turns = std::min(idle_turns, count_idle_game_turns(monster.energy_need, get_monster_speed(player_ptr, monster)));
+        if (idle_turns <= 0) {
+            return 0;
+        }
+    }
+
+    return idle_turns;
+}
+
+/*!
+ * @brief 何も起きないゲームターンの分だけモンスターの行動エネルギーをまとめて減らす
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param turns count_monster_idle_turns() 以下のゲームターン数
+ */
+void spend_monster_idle_turns(PlayerType *player_ptr, int turns)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    for (const auto m_idx : collect_energy_gaining_monsters(player_ptr)) {
+        auto &monster = floor.m_list[m_idx];
+        monster.energy_need -= static_cast<ACTION_ENERGY>(speed_to_energy(get_monster_speed(player_ptr, monster)) * turns);
+    }
+}
+
 /*!
  * @brief 後続のモンスター処理が必要かどうか判定する (要調査)
  * @param player_ptr プレイヤーへの参照ポインタ
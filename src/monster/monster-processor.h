@@ -5,3 +5,5 @@
 class PlayerType;
 void process_monsters(PlayerType *player_ptr);
 void process_monster(PlayerType *player_ptr, MONSTER_IDX m_idx);
+int count_monster_idle_turns(PlayerType *player_ptr, int max_turns);
+void spend_monster_idle_turns(PlayerType *player_ptr, int turns);
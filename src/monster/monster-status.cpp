@@ -24,13 +24,12 @@
 #include "tracking/health-bar-tracker.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
+#include <optional>
 #if JP
 #else
 #include "monster/monster-description-types.h"
 #endif
 
-static uint32_t csleep_noise;
-
 /*!
  * @brief モンスターIDからPOWERFULフラグの有無を取得する /
  * @param floor_ptr 現在フロアへの参照ポインタ
@@ -102,87 +101,123 @@ int mon_damage_mod(PlayerType *player_ptr, MonsterEntity *m_ptr, int dam, bool i
 }
 
 /*!
- * @brief モンスターの各種状態値を時間経過により更新するサブルーチン
- * @param floor_ptr 現在フロアへの参照ポインタ
- * @param m_idx モンスター参照ID
- * @param mte 更新するモンスターの時限ステータスID
+ * @brief 睡眠中のモンスター1体がプレイヤーの物音に気付いたかを判定する
+ * @param floor 現在フロアへの参照
+ * @param monster 睡眠中のモンスター
+ * @param csleep_noise プレイヤーの物音の大きさ
+ * @param player_energy プレイヤーの速度から求めたエネルギー量
+ * @return 気付いたならば覚醒量、気付かなければnullopt
  */
-static void process_monsters_mtimed_aux(PlayerType *player_ptr, MONSTER_IDX m_idx, MonsterTimedEffect mte)
+static std::optional<int> calc_sleep_wakeup(const FloorType &floor, const MonsterEntity &monster, uint32_t csleep_noise, int player_energy)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    auto *m_ptr = &floor.m_list[m_idx];
-    switch (mte) {
-    case MonsterTimedEffect::SLEEP: {
-        auto *r_ptr = &m_ptr->get_monrace();
-        auto is_wakeup = false;
-        if (m_ptr->cdis < MAX_MONSTER_SENSING) {
-            /* Handle "sensing radius" */
-            if (m_ptr->cdis <= (m_ptr->is_pet() ? ((r_ptr->aaf > MAX_PLAYER_SIGHT) ? MAX_PLAYER_SIGHT : r_ptr->aaf) : r_ptr->aaf)) {
-                is_wakeup = true;
-            }
+    if (monster.cdis >= MAX_MONSTER_SENSING) {
+        return std::nullopt;
+    }
 
-            /* Handle "sight" and "aggravation" */
-            else if ((m_ptr->cdis <= MAX_PLAYER_SIGHT) && floor.has_los({ m_ptr->fy, m_ptr->fx })) {
-                is_wakeup = true;
-            }
-        }
+    /* Handle "sensing radius", "sight" and "aggravation" */
+    const auto &monrace = monster.get_monrace();
+    const auto sensing_radius = monster.is_pet() ? std::min<int>(monrace.aaf, MAX_PLAYER_SIGHT) : monrace.aaf;
+    const auto is_sensed = monster.cdis <= sensing_radius;
+    if (!is_sensed && ((monster.cdis > MAX_PLAYER_SIGHT) || !floor.has_los(monster.get_position()))) {
+        return std::nullopt;
+    }
 
-        if (!is_wakeup) {
-            break;
-        }
+    auto notice = randnum0<uint32_t>(1024);
 
-        auto notice = randnum0<uint32_t>(1024);
+    /* Nightmare monsters are more alert */
+    if (ironman_nightmare) {
+        notice /= 2;
+    }
 
-        /* Nightmare monsters are more alert */
-        if (ironman_nightmare) {
-            notice /= 2;
-        }
+    /* Hack -- See if monster "notices" player */
+    if ((notice * notice * notice) > csleep_noise) {
+        return std::nullopt;
+    }
 
-        /* Hack -- See if monster "notices" player */
-        if ((notice * notice * notice) > csleep_noise) {
-            break;
-        }
+    /* Hack -- amount of "waking" */
+    /* Wake up faster near the player */
+    auto d = (monster.cdis < MAX_MONSTER_SENSING / 2) ? (MAX_MONSTER_SENSING / monster.cdis) : 1;
 
-        /* Hack -- amount of "waking" */
-        /* Wake up faster near the player */
-        auto d = (m_ptr->cdis < MAX_MONSTER_SENSING / 2) ? (MAX_MONSTER_SENSING / m_ptr->cdis) : 1;
+    /* Hack -- amount of "waking" is affected by speed of player */
+    d = (d * player_energy) / 10;
+    if (d < 0) {
+        d = 1;
+    }
+
+    return d;
+}
+
+/*!
+ * @brief 睡眠中の全モンスターについて、プレイヤーの物音で目を覚ますかをまとめて処理する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * 物音の大きさ等プレイヤー側の値は1回だけ計算し、各モンスターの判定で使い回す.
+ * 判定と覚醒量の反映は1体ずつ続けて行うので、乱数を引く順序
+ * (物音に気付いたかの判定と、目を覚ましたモンスターの名前を幻覚で決める分) は1体ずつ処理していた頃と同じである.
+ * 目を覚ましたモンスターはmproc_listの末尾と入れ替えて外されるので、後ろから処理すれば未処理のモンスターを飛ばさない.
+ */
+static void process_monsters_sleep(PlayerType *player_ptr)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    const auto &sleep_list = floor.mproc_list[MonsterTimedEffect::SLEEP];
 
-        /* Hack -- amount of "waking" is affected by speed of player */
-        d = (d * speed_to_energy(player_ptr->pspeed)) / 10;
-        if (d < 0) {
-            d = 1;
+    /* Hack -- calculate the "player noise" */
+    const auto csleep_noise = 1U << (30 - player_ptr->skill_stl);
+    const auto player_energy = speed_to_energy(player_ptr->pspeed);
+
+    auto &tracker = HealthBarTracker::get_instance();
+    for (auto i = floor.mproc_max[MonsterTimedEffect::SLEEP] - 1; i >= 0; i--) {
+        const auto m_idx = sleep_list[i];
+        tracker.set_flag_if_tracking(m_idx);
+        auto &monster = floor.m_list[m_idx];
+        const auto d = calc_sleep_wakeup(floor, monster, csleep_noise, player_energy);
+        if (!d) {
+            continue;
         }
 
+        auto &monrace = monster.get_monrace();
+
         /* Monster wakes up "a little bit" */
 
         /* Still asleep */
-        if (!set_monster_csleep(player_ptr, m_idx, m_ptr->get_remaining_sleep() - d)) {
+        if (!set_monster_csleep(player_ptr, m_idx, monster.get_remaining_sleep() - *d)) {
             /* Notice the "not waking up" */
-            if (is_original_ap_and_seen(player_ptr, m_ptr)) {
+            if (is_original_ap_and_seen(player_ptr, &monster)) {
                 /* Hack -- Count the ignores */
-                if (r_ptr->r_ignore < MAX_UCHAR) {
-                    r_ptr->r_ignore++;
+                if (monrace.r_ignore < MAX_UCHAR) {
+                    monrace.r_ignore++;
                 }
             }
 
-            break;
+            continue;
         }
 
         /* Notice the "waking up" */
-        if (m_ptr->ml) {
-            const auto m_name = monster_desc(player_ptr, m_ptr, 0);
+        if (monster.ml) {
+            const auto m_name = monster_desc(player_ptr, &monster, 0);
             msg_format(_("%s^が目を覚ました。", "%s^ wakes up."), m_name.data());
         }
 
-        if (is_original_ap_and_seen(player_ptr, m_ptr)) {
+        if (is_original_ap_and_seen(player_ptr, &monster)) {
             /* Hack -- Count the wakings */
-            if (r_ptr->r_wake < MAX_UCHAR) {
-                r_ptr->r_wake++;
+            if (monrace.r_wake < MAX_UCHAR) {
+                monrace.r_wake++;
             }
         }
-
-        break;
     }
+}
+
+/*!
+ * @brief モンスターの各種状態値を時間経過により更新するサブルーチン
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param m_idx モンスター参照ID
+ * @param mte 更新するモンスターの時限ステータスID
+ */
+static void process_monsters_mtimed_aux(PlayerType *player_ptr, MONSTER_IDX m_idx, MonsterTimedEffect mte)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    auto *m_ptr = &floor.m_list[m_idx];
+    switch (mte) {
     case MonsterTimedEffect::FAST:
         /* Reduce by one, note if expires */
         if (set_monster_fast(player_ptr, m_idx, m_ptr->get_remaining_acceleration() - 1)) {
@@ -282,14 +317,14 @@ static void process_monsters_mtimed_aux(PlayerType *player_ptr, MONSTER_IDX m_id
  */
 void process_monsters_mtimed(PlayerType *player_ptr, MonsterTimedEffect mte)
 {
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-    const auto &cur_mproc_list = floor_ptr->mproc_list[mte];
-
-    /* Hack -- calculate the "player noise" */
     if (mte == MonsterTimedEffect::SLEEP) {
-        csleep_noise = (1U << (30 - player_ptr->skill_stl));
+        process_monsters_sleep(player_ptr);
+        return;
     }
 
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto &cur_mproc_list = floor_ptr->mproc_list[mte];
+
     /* Process the monsters (backwards) */
     for (auto i = floor_ptr->mproc_max[mte] - 1; i >= 0; i--) {
         const auto m_idx = cur_mproc_list[i];
@@ -79,12 +79,14 @@ bool update_riding_monster(PlayerType *player_ptr, turn_flags *turn_flags_ptr, M
     if (g_ptr->has_monster()) {
         y_ptr->fy = oy;
         y_ptr->fx = ox;
+        player_ptr->current_floor_ptr->spatial_index.update_monster(g_ptr->m_idx, { oy, ox });
         update_monster(player_ptr, g_ptr->m_idx, true);
     }
 
     g_ptr->m_idx = m_idx;
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    player_ptr->current_floor_ptr->spatial_index.update_monster(m_idx, { ny, nx });
     update_monster(player_ptr, m_idx, true);
 
     lite_spot(player_ptr, oy, ox);
@@ -182,7 +184,7 @@ static um_type *initialize_um_type(PlayerType *player_ptr, um_type *um_ptr, MONS
     return um_ptr;
 }
 
-static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr)
+static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr, MONSTER_IDX m_idx)
 {
     if (!um_ptr->full) {
         return um_ptr->m_ptr->cdis;
@@ -200,6 +202,7 @@ static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr)
     }
 
     um_ptr->m_ptr->cdis = distance;
+    player_ptr->current_floor_ptr->monster_turn_states.set_distance(m_idx, distance);
     return distance;
 }
 
@@ -426,7 +429,7 @@ static bool check_invisible(PlayerType *player_ptr, um_type *um_ptr)
  */
 static void decide_sight_invisible_monster(PlayerType *player_ptr, um_type *um_ptr, MONSTER_IDX m_idx)
 {
-    POSITION distance = decide_updated_distance(player_ptr, um_ptr);
+    POSITION distance = decide_updated_distance(player_ptr, um_ptr, m_idx);
     auto *m_ptr = um_ptr->m_ptr;
     auto *r_ptr = &m_ptr->get_monrace();
 
@@ -52,7 +52,7 @@
 bool direct_beam(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2, MonsterEntity *m_ptr)
 {
     auto &floor = *player_ptr->current_floor_ptr;
-    ProjectionPath grid_g(player_ptr, AngbandSystem::get_instance().get_max_range(), { y1, x1 }, { y2, x2 }, PROJECT_THRU);
+    const auto &grid_g = ProjectionPathCache::get_instance().get(player_ptr, AngbandSystem::get_instance().get_max_range(), { y1, x1 }, { y2, x2 }, PROJECT_THRU);
     if (grid_g.path_num()) {
         return false;
     }
@@ -107,7 +107,8 @@ bool breath_direct(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2
     }
 
     auto &floor = *player_ptr->current_floor_ptr;
-    ProjectionPath grid_g(player_ptr, AngbandSystem::get_instance().get_max_range(), pos_source, pos_target, flg);
+    /* breath_shape() が projectable() で経路を引き直すのでコピーしておく */
+    const auto grid_g = ProjectionPathCache::get_instance().get(player_ptr, AngbandSystem::get_instance().get_max_range(), pos_source, pos_target, flg);
     auto path_n = 0;
     POSITION y = y1;
     POSITION x = x1;
@@ -196,7 +197,7 @@ bool breath_direct(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2
  */
 void get_project_point(PlayerType *player_ptr, POSITION sy, POSITION sx, POSITION *ty, POSITION *tx, BIT_FLAGS flg)
 {
-    ProjectionPath path_g(player_ptr, AngbandSystem::get_instance().get_max_range(), { sy, sx }, { *ty, *tx }, flg);
+    const auto &path_g = ProjectionPathCache::get_instance().get(player_ptr, AngbandSystem::get_instance().get_max_range(), { sy, sx }, { *ty, *tx }, flg);
     *ty = sy;
     *tx = sx;
     for (const auto &pos : path_g) {
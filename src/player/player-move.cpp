@@ -151,6 +151,7 @@ bool move_player_effect(PlayerType *player_ptr, POSITION ny, POSITION nx, BIT_FL
                 MonsterEntity *om_ptr = &floor.m_list[om_idx];
                 om_ptr->fy = pos_new.y;
                 om_ptr->fx = pos_new.x;
+                floor.spatial_index.update_monster(om_idx, pos_new);
                 update_monster(player_ptr, om_idx, true);
             }
 
@@ -158,6 +159,7 @@ bool move_player_effect(PlayerType *player_ptr, POSITION ny, POSITION nx, BIT_FL
                 MonsterEntity *nm_ptr = &floor.m_list[nm_idx];
                 nm_ptr->fy = pos_old.y;
                 nm_ptr->fx = pos_old.x;
+                floor.spatial_index.update_monster(nm_idx, pos_old);
                 update_monster(player_ptr, nm_idx, true);
             }
         }
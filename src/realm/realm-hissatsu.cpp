@@ -275,6 +275,7 @@ std::optional<std::string> do_hissatsu_spell(PlayerType *player_ptr, SPELL_IDX s
                     floor.get_grid(target).m_idx = m_idx;
                     monster.fy = target.y;
                     monster.fx = target.x;
+                    floor.spatial_index.update_monster(m_idx, target);
 
                     update_monster(player_ptr, m_idx, true);
                     lite_spot(player_ptr, origin.y, origin.x);
@@ -560,6 +561,7 @@ std::optional<std::string> do_hissatsu_spell(PlayerType *player_ptr, SPELL_IDX s
                 floor.get_grid(pos_new).m_idx = m_idx;
                 monster.fy = pos_new.y;
                 monster.fx = pos_new.x;
+                floor.spatial_index.update_monster(m_idx, pos_new);
 
                 update_monster(player_ptr, m_idx, true);
 
@@ -269,6 +269,7 @@ bool earthquake(PlayerType *player_ptr, POSITION cy, POSITION cx, POSITION r, MO
             floor.get_grid(p_pos_new).m_idx = m_idx_aux;
             m_ptr->fy = p_pos_new.y;
             m_ptr->fx = p_pos_new.x;
+            floor.spatial_index.update_monster(m_idx_aux, p_pos_new);
             update_monster(player_ptr, m_idx_aux, true);
             lite_spot(player_ptr, pos.y, pos.x);
             lite_spot(player_ptr, p_pos_new.y, p_pos_new.x);
@@ -183,23 +183,10 @@ bool detect_objects_gold(PlayerType *player_ptr, POSITION range)
 
     /* Scan objects */
     bool detect = false;
-    POSITION y, x;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
+    for (const auto i : floor.spatial_index.find_items(player_ptr->get_position(), range2)) {
         auto *o_ptr = &floor.o_list[i];
-
-        if (!o_ptr->is_valid()) {
-            continue;
-        }
-        if (o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        y = o_ptr->iy;
-        x = o_ptr->ix;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range2) {
-            continue;
-        }
-
+        const auto y = o_ptr->iy;
+        const auto x = o_ptr->ix;
         if (o_ptr->bi_key.tval() == ItemKindType::GOLD) {
             o_ptr->marked.set(OmType::FOUND);
             lite_spot(player_ptr, y, x);
@@ -236,23 +223,10 @@ bool detect_objects_normal(PlayerType *player_ptr, POSITION range)
     }
 
     bool detect = false;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
+    for (const auto i : floor.spatial_index.find_items(player_ptr->get_position(), range2)) {
         auto *o_ptr = &floor.o_list[i];
-
-        if (!o_ptr->is_valid()) {
-            continue;
-        }
-        if (o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        POSITION y = o_ptr->iy;
-        POSITION x = o_ptr->ix;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range2) {
-            continue;
-        }
-
+        const auto y = o_ptr->iy;
+        const auto x = o_ptr->ix;
         if (o_ptr->bi_key.tval() != ItemKindType::GOLD) {
             o_ptr->marked.set(OmType::FOUND);
             lite_spot(player_ptr, y, x);
@@ -306,18 +280,10 @@ bool detect_objects_magic(PlayerType *player_ptr, POSITION range)
     }
 
     auto detect = false;
-    for (OBJECT_IDX i = 1; i < floor.o_max; i++) {
+    for (const auto i : floor.spatial_index.find_items(player_ptr->get_position(), range)) {
         auto *o_ptr = &floor.o_list[i];
-        if (!o_ptr->is_valid() || o_ptr->is_held_by_monster()) {
-            continue;
-        }
-
-        auto y = o_ptr->iy;
-        auto x = o_ptr->ix;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
+        const auto y = o_ptr->iy;
+        const auto x = o_ptr->ix;
         auto has_bonus = o_ptr->to_a > 0;
         has_bonus |= o_ptr->to_h + o_ptr->to_d > 0;
         if (o_ptr->is_fixed_or_random_artifact() || o_ptr->is_ego() || is_object_magically(o_ptr->bi_key.tval()) || o_ptr->is_spell_book() || has_bonus) {
@@ -349,19 +315,9 @@ bool detect_monsters_normal(PlayerType *player_ptr, POSITION range)
     }
 
     bool flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (r_ptr->misc_flags.has_not(MonsterMiscType::INVISIBLE) || player_ptr->see_inv) {
             m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
             update_monster(player_ptr, i, false);
@@ -395,21 +351,9 @@ bool detect_monsters_invis(PlayerType *player_ptr, POSITION range)
     const auto &tracker = LoreTracker::get_instance();
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (r_ptr->misc_flags.has(MonsterMiscType::INVISIBLE)) {
             if (tracker.is_tracking(m_ptr->r_idx)) {
                 rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
@@ -447,20 +391,9 @@ bool detect_monsters_evil(PlayerType *player_ptr, POSITION range)
     const auto &tracker = LoreTracker::get_instance();
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (r_ptr->kind_flags.has(MonsterKindType::EVIL)) {
             if (m_ptr->is_original_ap()) {
                 r_ptr->r_kind_flags.set(MonsterKindType::EVIL);
@@ -498,18 +431,8 @@ bool detect_monsters_nonliving(PlayerType *player_ptr, POSITION range)
     const auto &tracker = LoreTracker::get_instance();
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (!m_ptr->has_living_flag()) {
             if (tracker.is_tracking(m_ptr->r_idx)) {
                 rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
@@ -544,20 +467,9 @@ bool detect_monsters_mind(PlayerType *player_ptr, POSITION range)
     const auto &tracker = LoreTracker::get_instance();
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (r_ptr->misc_flags.has_not(MonsterMiscType::EMPTY_MIND)) {
             if (tracker.is_tracking(m_ptr->r_idx)) {
                 rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
@@ -593,20 +505,9 @@ bool detect_monsters_string(PlayerType *player_ptr, POSITION range, concptr Matc
     const auto &tracker = LoreTracker::get_instance();
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : floor.spatial_index.find_monsters(player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         const auto &monrace = m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (angband_strchr(Match, monrace.symbol_definition.character)) {
             if (tracker.is_tracking(m_ptr->r_idx)) {
                 rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
@@ -108,6 +108,7 @@ void fetch_item(PlayerType *player_ptr, DIRECTION dir, WEIGHT wgt, bool require_
     floor.grid_array[p_pos.y][p_pos.x].o_idx_list.add(&floor, i); /* 'move' it */
     item.iy = p_pos.y;
     item.ix = p_pos.x;
+    floor.spatial_index.update_item(i, p_pos);
 
     const auto item_name = describe_flavor(player_ptr, item, OD_NAME_ONLY);
     msg_format(_("%s^があなたの足元に飛んできた。", "%s^ flies through the air to your feet."), item_name.data());
@@ -156,6 +157,7 @@ bool fetch_monster(PlayerType *player_ptr)
     floor.get_grid({ ty, tx }).m_idx = m_idx;
     monster.fy = ty;
     monster.fx = tx;
+    floor.spatial_index.update_monster(m_idx, monster.get_position());
     (void)set_monster_csleep(player_ptr, m_idx, 0);
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, target_row, target_col);
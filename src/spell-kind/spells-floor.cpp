@@ -50,6 +50,7 @@
 #include "system/redrawing-flags-updater.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 
@@ -138,28 +139,11 @@ void wiz_lite(PlayerType *player_ptr, bool ninja)
  */
 void wiz_dark(PlayerType *player_ptr)
 {
-    /* Forget every grid */
-    for (POSITION y = 1; y < player_ptr->current_floor_ptr->height - 1; y++) {
-        for (POSITION x = 1; x < player_ptr->current_floor_ptr->width - 1; x++) {
-            auto *g_ptr = &player_ptr->current_floor_ptr->grid_array[y][x];
-
-            /* Process the grid */
-            g_ptr->info &= ~(CAVE_MARK | CAVE_IN_DETECT | CAVE_KNOWN);
-            g_ptr->info |= (CAVE_UNSAFE);
-        }
-    }
-
-    /* Forget every grid on horizontal edge */
-    for (POSITION x = 0; x < player_ptr->current_floor_ptr->width; x++) {
-        player_ptr->current_floor_ptr->grid_array[0][x].info &= ~(CAVE_MARK);
-        player_ptr->current_floor_ptr->grid_array[player_ptr->current_floor_ptr->height - 1][x].info &= ~(CAVE_MARK);
-    }
-
-    /* Forget every grid on vertical edge */
-    for (POSITION y = 1; y < (player_ptr->current_floor_ptr->height - 1); y++) {
-        player_ptr->current_floor_ptr->grid_array[y][0].info &= ~(CAVE_MARK);
-        player_ptr->current_floor_ptr->grid_array[y][player_ptr->current_floor_ptr->width - 1].info &= ~(CAVE_MARK);
-    }
+    /* Forget every grid (including edges) */
+    auto &floor = *player_ptr->current_floor_ptr;
+    const auto area = floor.get_area();
+    floor.update_grid_info(area, CAVE_MARK);
+    floor.update_grid_info(area.resized(-1), CAVE_IN_DETECT | CAVE_KNOWN, CAVE_UNSAFE);
 
     /* Forget all objects */
     for (OBJECT_IDX i = 1; i < player_ptr->current_floor_ptr->o_max; i++) {
@@ -428,6 +412,7 @@ bool destroy_area(PlayerType *player_ptr, const POSITION y1, const POSITION x1,
         }
     }
 
+    ProjectionPathCache::get_instance().invalidate();
     if (in_generate) {
         return true;
     }
@@ -115,6 +115,8 @@ bool polymorph_monster(PlayerType *player_ptr, POSITION y, POSITION x)
         m_idx = place_specific_monster(player_ptr, y, x, old_r_idx, (mode | PM_NO_KAGE | PM_IGNORE_TERRAIN));
         if (m_idx) {
             floor_ptr->m_list[*m_idx] = back_m.clone();
+            floor_ptr->spatial_index.update_monster(*m_idx, back_m.get_position());
+            floor_ptr->monster_turn_states.update(*m_idx, floor_ptr->m_list[*m_idx]);
             floor_ptr->reset_mproc();
         } else {
             preserve_hold_objects = false;
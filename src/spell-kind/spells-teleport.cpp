@@ -178,6 +178,7 @@ bool teleport_away(PlayerType *player_ptr, MONSTER_IDX m_idx, POSITION dis, tele
 
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    player_ptr->current_floor_ptr->spatial_index.update_monster(m_idx, { ny, nx });
 
     m_ptr->reset_target();
     update_monster(player_ptr, m_idx, true);
@@ -260,6 +261,7 @@ void teleport_monster_to(PlayerType *player_ptr, MONSTER_IDX m_idx, POSITION ty,
 
     m_ptr->fy = ny;
     m_ptr->fx = nx;
+    player_ptr->current_floor_ptr->spatial_index.update_monster(m_idx, { ny, nx });
 
     update_monster(player_ptr, m_idx, true);
     lite_spot(player_ptr, oy, ox);
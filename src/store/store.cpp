@@ -25,6 +25,7 @@
 #include "store/store-util.h"
 #include "sv-definition/sv-lite-types.h"
 #include "sv-definition/sv-scroll-types.h"
+#include "system/baseitem/baseitem-allocation.h"
 #include "system/floor/floor-info.h"
 #include "system/floor/town-info.h"
 #include "system/floor/town-list.h"
@@ -48,6 +49,11 @@ short cur_store_feat;
 /* Enable "increments" */
 bool allow_inc = false;
 
+namespace {
+constexpr auto BLACK_MARKET_LEVEL_MIN = 25; //!< ブラックマーケットの品物の最低生成階層
+constexpr auto BLACK_MARKET_LEVEL_RANGE = 25; //!< ブラックマーケットの品物の生成階層の幅
+}
+
 /*!
  * @brief 店舗の最大スロット数を返す
  * @param store_idx 店舗ID
@@ -320,7 +326,7 @@ static void store_create(PlayerType *player_ptr, short fix_k_idx, StoreSaleType
         short bi_id;
         DEPTH level;
         if (store_num == StoreSaleType::BLACK) {
-            level = 25 + randint0(25);
+            level = BLACK_MARKET_LEVEL_MIN + randint0(BLACK_MARKET_LEVEL_RANGE);
             bi_id = player_ptr->current_floor_ptr->select_baseitem_id(level, 0x00000000);
             if (bi_id == 0) {
                 continue;
@@ -379,13 +385,45 @@ static void store_create(PlayerType *player_ptr, short fix_k_idx, StoreSaleType
     }
 }
 
+/*!
+ * @brief 経過した回数分の品揃えの入れ替え数を求める
+ * @param remain 入れ替えられる数の上限
+ * @param chance 経過した入れ替えの回数
+ * @return 入れ替える数
+ * @details 削除数と補充数で同じ計算をするため関数に括り出したもの.
+ * 毎回の入れ替え数を残りの上限から順に差し引くので、何回分経過しても上限を超えない.
+ */
+static int calc_turnover(int remain, int chance)
+{
+    auto turnover = 1;
+    for (auto i = 0; i < chance; i++) {
+        const auto n = randint0(remain);
+        turnover += n;
+        remain -= n;
+    }
+
+    return turnover;
+}
+
+/*!
+ * @brief 品揃えの補充に使う抽選テーブルを予め作っておく
+ * @details ブラックマーケットは何度も生成をやり直すので、階層毎の抽選テーブルを使い回す.
+ * 地上に移動した時にも呼び、店に入った時に作る手間を省く.
+ */
+void prepare_store_stock_tables()
+{
+    const auto &table = BaseitemAllocationTable::get_instance();
+    table.prepare_lottery_tables(BLACK_MARKET_LEVEL_MIN, BLACK_MARKET_LEVEL_MIN + BLACK_MARKET_LEVEL_RANGE - 1, 0);
+}
+
 /*!
  * @brief 店の品揃えを変化させる /
  * Maintain the inventory at the stores.
  * @param player_ptr プレイヤーへの参照ポインタ
  * @param town_num 町のID
  * @param store_num 店舗種類のID
- * @param chance 更新商品数
+ * @param chance 経過した入れ替えの回数
+ * @details ブラックマーケットは補充の前に抽選テーブルを用意し、生成のやり直し毎に作り直さないようにする.
  */
 void store_maintenance(PlayerType *player_ptr, int town_num, StoreSaleType store_num, int chance)
 {
@@ -406,46 +444,20 @@ void store_maintenance(PlayerType *player_ptr, int town_num, StoreSaleType store
         }
     }
 
-    INVENTORY_IDX j = st_ptr->stock_num;
-    int remain = STORE_TURNOVER + std::max(0, j - STORE_MAX_KEEP);
-    int turn_over = 1;
-    for (int i = 0; i < chance; i++) {
-        auto n = randint0(remain);
-        turn_over += n;
-        remain -= n;
-    }
-
-    j = j - turn_over;
-    if (j > STORE_MAX_KEEP) {
-        j = STORE_MAX_KEEP;
-    }
-    if (j < STORE_MIN_KEEP) {
-        j = STORE_MIN_KEEP;
-    }
-
-    while (st_ptr->stock_num > j) {
+    const auto num_keep = std::clamp<int>(st_ptr->stock_num - calc_turnover(STORE_TURNOVER + std::max(0, st_ptr->stock_num - STORE_MAX_KEEP), chance), STORE_MIN_KEEP, STORE_MAX_KEEP);
+    while (st_ptr->stock_num > num_keep) {
         st_ptr->delete_item();
     }
 
-    remain = STORE_MAX_KEEP - st_ptr->stock_num;
-    turn_over = 1;
-    for (int i = 0; i < chance; i++) {
-        auto n = randint0(remain);
-        turn_over += n;
-        remain -= n;
-    }
-
-    j = st_ptr->stock_num + turn_over;
-    if (j > STORE_MAX_KEEP) {
-        j = STORE_MAX_KEEP;
-    }
-    if (j < STORE_MIN_KEEP) {
-        j = STORE_MIN_KEEP;
-    }
+    auto j = std::clamp<int>(st_ptr->stock_num + calc_turnover(STORE_MAX_KEEP - st_ptr->stock_num, chance), STORE_MIN_KEEP, STORE_MAX_KEEP);
     if (j >= st_ptr->stock_size) {
         j = st_ptr->stock_size - 1;
     }
 
+    if (store_num == StoreSaleType::BLACK) {
+        prepare_store_stock_tables();
+    }
+
     for (size_t k = 0; k < st_ptr->regular.size(); k++) {
         store_create(player_ptr, st_ptr->regular[k], store_num);
         if (st_ptr->stock_num >= STORE_MAX_KEEP) {
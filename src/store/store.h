@@ -27,6 +27,7 @@ extern bool allow_inc;
 class PlayerType;
 int16_t store_get_stock_max(StoreSaleType sst, bool powerup = true);
 void store_shuffle(PlayerType *player_ptr, StoreSaleType which);
+void prepare_store_stock_tables();
 void store_maintenance(PlayerType *player_ptr, int town_num, StoreSaleType store_num, int chance);
 void store_init(int town_num, StoreSaleType store_num);
 void store_examine(PlayerType *player_ptr, StoreSaleType store_num);
@@ -13,6 +13,12 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+class GameDataLoadException : public std::runtime_error {
+public:
+    GameDataLoadException() = delete;
+    using std::runtime_error::runtime_error;
+};
+
 namespace angband::exception::detail {
 
 template <std::derived_from<std::exception> T>
@@ -2,6 +2,7 @@
 #include "util/string-processor.h"
 
 AngbandSystem AngbandSystem::instance{};
+thread_local Xoshiro128StarStar *AngbandSystem::bound_rng = nullptr;
 
 AngbandSystem &AngbandSystem::get_instance()
 {
@@ -47,14 +48,19 @@ void AngbandSystem::set_seed_town(const uint32_t seed)
     this->seed_town = seed;
 }
 
+/*!
+ * @brief 現在のスレッドで使う乱数生成器を返す
+ * @details RngStreamScope で乱数ストリームが束縛されていればそれを、無ければゲーム本体の乱数生成器を返す.
+ * @return 乱数生成器への参照
+ */
 Xoshiro128StarStar &AngbandSystem::get_rng()
 {
-    return this->rng;
+    return bound_rng ? *bound_rng : this->rng;
 }
 
 void AngbandSystem::set_rng(const Xoshiro128StarStar &rng_)
 {
-    this->rng = rng_;
+    this->get_rng() = rng_;
 }
 
 AngbandVersion &AngbandSystem::get_version()
@@ -33,7 +33,9 @@ public:
 private:
     AngbandSystem() = default;
 
+    friend class RngStreamScope;
     static AngbandSystem instance;
+    static thread_local Xoshiro128StarStar *bound_rng; //!< このスレッドに束縛された乱数ストリーム (無ければ rng を使う)
     bool phase_out_stat = false; // カジノ闘技場の観戦状態等に利用。NPCの処理の対象にならず自身もほとんどの行動ができない.
     Xoshiro128StarStar rng; //!< Uniform random bit generator for <random>
     uint32_t seed_flavor{}; /* アイテム未鑑定名をシャッフルするための乱数シード */
@@ -11,6 +11,7 @@
 #include "system/baseitem/baseitem-list.h"
 #include "system/system-variables.h"
 #include <array>
+#include <optional>
 
 BaseitemAllocationEntry::BaseitemAllocationEntry(short index, int level, short prob1, short prob2)
     : index(index)
@@ -85,6 +86,7 @@ void BaseitemAllocationTable::initialize()
     }
 
     this->entries = std::vector<BaseitemAllocationEntry>(allocation_size);
+    this->lottery_tables.clear();
     std::array<short, MAX_DEPTH> aux{};
     for (const auto &baseitem : baseitems) {
         for (const auto &[level, chance] : baseitem.alloc_tables) {
@@ -114,7 +116,8 @@ BaseitemAllocationEntry &BaseitemAllocationTable::get_entry(int index)
 
 short BaseitemAllocationTable::draw_lottery(int level, uint32_t mode, int count) const
 {
-    const auto prob_table = this->make_table(level, mode);
+    std::optional<ProbabilityTable<int>> restricted_table;
+    const auto &prob_table = this->is_restricted ? restricted_table.emplace(this->make_table(level, mode)) : this->get_lottery_table(level, mode);
     if (prob_table.empty()) {
         return 0;
     }
@@ -132,12 +135,27 @@ bool BaseitemAllocationTable::order_level(int index1, int index2) const
     return entry1.order_level(entry2);
 }
 
+/*!
+ * @brief 抽選テーブルを予め作っておく
+ * @param level_min 最小の生成階層
+ * @param level_max 最大の生成階層
+ * @param mode 生成モード
+ * @details 店の品揃えの補充等、同じ範囲の階層で何度も抽選する前に呼ぶ.
+ */
+void BaseitemAllocationTable::prepare_lottery_tables(int level_min, int level_max, uint32_t mode) const
+{
+    for (auto level = level_min; level <= level_max; level++) {
+        (void)this->get_lottery_table(level, mode);
+    }
+}
+
 /*!
  * @brief オブジェクト生成テーブルに生成制約を加える
  * @todo select_baseitem_id_hook グローバル関数ポインタは引数化して除去する
  */
 void BaseitemAllocationTable::prepare_allocation()
 {
+    this->is_restricted = select_baseitem_id_hook != nullptr;
     for (auto &entry : this->entries) {
         if (!select_baseitem_id_hook || (*select_baseitem_id_hook)(entry.index)) {
             entry.prob2 = entry.prob1;
@@ -173,3 +191,20 @@ ProbabilityTable<int> BaseitemAllocationTable::make_table(int level, uint32_t mo
 
     return prob_table;
 }
+
+/*!
+ * @brief 生成制約が無い時の抽選テーブルを返す
+ * @param level 生成階層
+ * @param mode 生成モード
+ * @details 生成制約が無ければ各エントリの確率は不変なので、一度作ったテーブルを使い回す.
+ */
+const ProbabilityTable<int> &BaseitemAllocationTable::get_lottery_table(int level, uint32_t mode) const
+{
+    const auto key = std::make_pair(level, mode & (AM_FORBID_CHEST | AM_GOLD));
+    const auto it = this->lottery_tables.find(key);
+    if (it != this->lottery_tables.end()) {
+        return it->second;
+    }
+
+    return this->lottery_tables.emplace(key, this->make_table(key.first, key.second)).first->second;
+}
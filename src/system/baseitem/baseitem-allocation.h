@@ -8,6 +8,8 @@
 
 #include "util/abstract-vector-wrapper.h"
 #include "util/probability-table.h"
+#include <map>
+#include <utility>
 
 /*
  * An entry for the object/monster allocation functions
@@ -48,6 +50,7 @@ public:
     const BaseitemAllocationEntry &get_entry(int index) const;
     BaseitemAllocationEntry &get_entry(int index);
     short draw_lottery(int level, uint32_t mode, int count) const;
+    void prepare_lottery_tables(int level_min, int level_max, uint32_t mode) const;
     bool order_level(int index1, int index2) const;
 
     void prepare_allocation();
@@ -56,6 +59,8 @@ private:
     static BaseitemAllocationTable instance;
     BaseitemAllocationTable() = default;
     std::vector<BaseitemAllocationEntry> entries;
+    bool is_restricted = false; //!< select_baseitem_id_hook による生成制約が掛かっているか
+    mutable std::map<std::pair<int, uint32_t>, ProbabilityTable<int>> lottery_tables; //!< 生成制約が無い時の階層・生成モード毎の抽選テーブル
 
     std::vector<BaseitemAllocationEntry> &get_inner_container() override
     {
@@ -63,4 +68,5 @@ private:
     }
 
     ProbabilityTable<int> make_table(int level, uint32_t mode) const;
+    const ProbabilityTable<int> &get_lottery_table(int level, uint32_t mode) const;
 };
@@ -45,6 +45,34 @@ const Grid &FloorType::get_grid(const Pos2D pos) const
     return this->grid_array[pos.y][pos.x];
 }
 
+/*!
+ * @brief フロア全体の範囲を返す
+ * @return 左上が(0, 0)、右下が(height - 1, width - 1)の長方形
+ */
+Rect2D FloorType::get_area() const
+{
+    return { Pos2D(0, 0), Pos2D(this->height - 1, this->width - 1) };
+}
+
+/*!
+ * @brief 範囲内の全マスの状態フラグを一括で更新する
+ * @details 行毎に連続したメモリを走査するだけの単純なループにしておき、フロア全体を処理する場合でも
+ * メモリ帯域以外がボトルネックにならないようにする.
+ * @param area 更新する範囲 (フロア外にはみ出していてはならない)
+ * @param flags_to_reset 落とすフラグ
+ * @param flags_to_add 立てるフラグ (落とした後に立てる)
+ */
+void FloorType::update_grid_info(const Rect2D &area, BIT_FLAGS flags_to_reset, BIT_FLAGS flags_to_add)
+{
+    for (auto y = area.top_left.y; y <= area.bottom_right.y; y++) {
+        auto &row = this->grid_array[y];
+        const auto end = row.begin() + area.bottom_right.x + 1;
+        for (auto it = row.begin() + area.top_left.x; it != end; ++it) {
+            it->info = (it->info & ~flags_to_reset) | flags_to_add;
+        }
+    }
+}
+
 bool FloorType::is_underground() const
 {
     return this->dun_level > 0;
@@ -371,6 +399,40 @@ void FloorType::reset_mproc_max()
     }
 }
 
+/*!
+ * @brief ターン処理用のモンスターの状態の複製を作り直す
+ * @details フロアの生成・読み込み直後に呼ぶ.
+ */
+void FloorType::reset_monster_turn_states()
+{
+    this->monster_turn_states.reset();
+    for (short i = 1; i < this->m_max; i++) {
+        this->monster_turn_states.update(i, this->m_list[i]);
+    }
+}
+
+/*!
+ * @brief モンスターと床上アイテムの位置索引を作り直す
+ * @details フロアの生成・読み込み直後など、索引と実際の配置がずれている可能性がある時に呼ぶ.
+ */
+void FloorType::reset_spatial_index()
+{
+    this->spatial_index.reset(this->height, this->width);
+    for (short i = 1; i < this->m_max; i++) {
+        const auto &monster = this->m_list[i];
+        if (monster.is_valid()) {
+            this->spatial_index.update_monster(i, monster.get_position());
+        }
+    }
+
+    for (short i = 1; i < this->o_max; i++) {
+        const auto &item = this->o_list[i];
+        if (item.is_valid() && !item.is_held_by_monster()) {
+            this->spatial_index.update_item(i, { item.iy, item.ix });
+        }
+    }
+}
+
 /*!
  * @brief モンスターの時限ステータスを取得する
  * @param m_idx モンスターの参照ID
@@ -416,10 +478,22 @@ void FloorType::remove_mproc(short m_idx, MonsterTimedEffect mte)
 
 /*!
  * @brief モンスター配列の空きを探す
+ * @details 削除されて空いた添字があればそれを優先して再利用し、配列の使用中の長さを伸ばさないようにする.
+ * ただし今のゲームターンに削除された添字は、ターンのモンスター処理が終わるまで再利用しない.
  * @return 使われていないモンスターのフロア内インデックス
  */
 short FloorType::pop_empty_index_monster()
 {
+    /* Recycle released monsters */
+    while (!this->released_monster_indices.empty()) {
+        const auto i = this->released_monster_indices.back();
+        this->released_monster_indices.pop_back();
+        if ((i < this->m_max) && !this->m_list[i].is_valid()) {
+            this->m_cnt++;
+            return i;
+        }
+    }
+
     /* Normal allocation */
     if (this->m_max < MAX_FLOOR_MONSTERS) {
         const auto i = this->m_max;
@@ -448,10 +522,20 @@ short FloorType::pop_empty_index_monster()
 
 /*!
  * @brief アイテム配列から空きを取得する
+ * @details 削除されて空いた添字があればそれを優先して再利用し、配列の使用中の長さを伸ばさないようにする.
  * @return 使われていないアイテムのフロア内インデックス
  */
 short FloorType::pop_empty_index_item()
 {
+    while (!this->released_item_indices.empty()) {
+        const auto i = this->released_item_indices.back();
+        this->released_item_indices.pop_back();
+        if ((i < this->o_max) && !this->o_list[i].is_valid()) {
+            this->o_cnt++;
+            return i;
+        }
+    }
+
     if (this->o_max < MAX_FLOOR_ITEMS) {
         const auto i = this->o_max;
         this->o_max++;
@@ -475,6 +559,55 @@ short FloorType::pop_empty_index_item()
     return 0;
 }
 
+/*!
+ * @brief 削除したモンスターの添字を再利用待ちにする
+ * @param m_idx 削除したモンスターのフロア内インデックス
+ * @details 同じゲームターンに生成されたモンスターへ添字を渡すと、sweep_monster_process() が
+ * 削除前のモンスターとして行動させてしまうため、ターンのモンスター処理が終わるまで取り置く.
+ */
+void FloorType::release_monster_index(short m_idx)
+{
+    this->held_monster_indices.push_back(m_idx);
+}
+
+/*!
+ * @brief 削除したアイテムの添字を次の割り当てで再利用できるようにする
+ * @param item_idx 削除したアイテムのフロア内インデックス
+ */
+void FloorType::release_item_index(short item_idx)
+{
+    this->released_item_indices.push_back(item_idx);
+}
+
+/*!
+ * @brief 取り置いていたモンスターの添字を次の割り当てで再利用できるようにする
+ * @details ゲームターンのモンスター処理を終えた時に呼ぶ.
+ */
+void FloorType::recycle_held_monster_indices()
+{
+    this->released_monster_indices.insert(this->released_monster_indices.end(), this->held_monster_indices.begin(), this->held_monster_indices.end());
+    this->held_monster_indices.clear();
+}
+
+/*!
+ * @brief 再利用待ちのモンスターの添字を破棄する
+ * @details モンスター配列を詰め直したり全消去したりして、添字の意味が変わった時に呼ぶ.
+ */
+void FloorType::clear_released_monster_indices()
+{
+    this->released_monster_indices.clear();
+    this->held_monster_indices.clear();
+}
+
+/*!
+ * @brief 再利用待ちのアイテムの添字を破棄する
+ * @details アイテム配列を詰め直したり全消去したりして、添字の意味が変わった時に呼ぶ.
+ */
+void FloorType::clear_released_item_indices()
+{
+    this->released_item_indices.clear();
+}
+
 /*!
  * @brief 指定された座標が地震や階段生成の対象となるマスかを返す。
  * @param player_ptr プレイヤーへの参照ポインタ
@@ -4,6 +4,8 @@
 #include "system/angband.h"
 #include "system/baseitem/baseitem-definition.h"
 #include "system/baseitem/baseitem-list.h"
+#include "system/floor/floor-spatial-index.h"
+#include "system/floor/monster-turn-states.h"
 #include "util/point-2d.h"
 #include <array>
 #include <map>
@@ -72,6 +74,11 @@ public:
 
     std::map<MonsterTimedEffect, std::vector<short>> mproc_list; /*!< The array to process dungeon monsters[max_m_idx] */
     std::map<MonsterTimedEffect, short> mproc_max; /*!< Number of monsters to be processed */
+    FloorSpatialIndex spatial_index; /*!< モンスターと床上アイテムの位置索引 */
+    MonsterTurnStates monster_turn_states; /*!< ターン処理用のモンスターの状態の複製 */
+    std::vector<short> released_monster_indices; /*!< 削除されて空いたモンスター配列の添字 */
+    std::vector<short> held_monster_indices; /*!< 今のゲームターンに削除されたモンスター配列の添字. ターン中は再利用しない */
+    std::vector<short> released_item_indices; /*!< 削除されて空いたアイテム配列の添字 */
 
     POSITION_IDX lite_n = 0; //!< Array of grids lit by player lite
     std::array<POSITION, LITE_MAX> lite_y{};
@@ -95,6 +102,8 @@ public:
 
     Grid &get_grid(const Pos2D pos);
     const Grid &get_grid(const Pos2D pos) const;
+    Rect2D get_area() const;
+    void update_grid_info(const Rect2D &area, BIT_FLAGS flags_to_reset, BIT_FLAGS flags_to_add = 0);
     bool is_underground() const;
     bool is_in_quest() const;
     void set_dungeon_index(DungeonId id);
@@ -123,9 +132,16 @@ public:
     std::optional<int> get_mproc_index(short m_idx, MonsterTimedEffect mte);
     void add_mproc(short m_idx, MonsterTimedEffect mte);
     void remove_mproc(short m_idx, MonsterTimedEffect mte);
+    void reset_spatial_index();
+    void reset_monster_turn_states();
 
     short pop_empty_index_monster();
     short pop_empty_index_item();
+    void release_monster_index(short m_idx);
+    void release_item_index(short item_idx);
+    void recycle_held_monster_indices();
+    void clear_released_monster_indices();
+    void clear_released_item_indices();
     bool is_grid_changeable(const Pos2D &pos) const;
     void place_random_stairs(const Pos2D &pos);
     void set_terrain_id(const Pos2D &pos, TerrainTag tag);
@@ -0,0 +1,290 @@
+#include "system/floor/floor-spatial-index.h"
+#include "floor/geometry.h"
+#include <algorithm>
+#include <utility>
+
+/*!
+ * @brief 索引を空にしてフロアの大きさを設定する
+ * @param height フロアの高さ
+ * @param width フロアの幅
+ */
+void FloorSpatialIndex::reset(int height, int width)
+{
+    this->height = height;
+    this->width = width;
+    const auto bucket_rows = (height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    const auto bucket_cols = (width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    this->monsters.reset(bucket_rows, bucket_cols);
+    this->items.reset(bucket_rows, bucket_cols);
+}
+
+/*!
+ * @brief モンスターの位置を登録/更新する
+ * @param m_idx モンスターID
+ * @param pos モンスターの現在位置
+ */
+void FloorSpatialIndex::update_monster(short m_idx, const Pos2D &pos)
+{
+    this->monsters.update(m_idx, pos);
+}
+
+void FloorSpatialIndex::remove_monster(short m_idx)
+{
+    this->monsters.remove(m_idx);
+}
+
+/*!
+ * @brief 床上アイテムの位置を登録/更新する
+ * @param item_idx アイテムID
+ * @param pos アイテムの現在位置
+ */
+void FloorSpatialIndex::update_item(short item_idx, const Pos2D &pos)
+{
+    this->items.update(item_idx, pos);
+}
+
+void FloorSpatialIndex::remove_item(short item_idx)
+{
+    this->items.remove(item_idx);
+}
+
+/*!
+ * @brief 長方形の範囲内にいるモンスターを返す
+ * @param area 範囲 (フロア外にはみ出していても良い)
+ * @return モンスターIDのリスト
+ */
+std::vector<short> FloorSpatialIndex::find_monsters(const Rect2D &area) const
+{
+    const auto clipped_area = this->clip(area);
+    return clipped_area ? this->monsters.find(*clipped_area) : std::vector<short>();
+}
+
+/*!
+ * @brief 指定座標から distance() で radius 以内にいるモンスターを返す
+ * @param center 中心座標
+ * @param radius 半径
+ * @return モンスターIDのリスト
+ */
+std::vector<short> FloorSpatialIndex::find_monsters(const Pos2D &center, int radius) const
+{
+    const auto clipped_area = this->clip(Rect2D(center, Pos2DVec(radius, radius)));
+    return clipped_area ? this->monsters.find(*clipped_area, center, radius) : std::vector<short>();
+}
+
+/*!
+ * @brief 指定座標に近い順にモンスターを返す
+ * @param center 中心座標
+ * @param count 最大数
+ * @return モンスターIDのリスト (近い順、同じ距離ならID順)
+ */
+std::vector<short> FloorSpatialIndex::find_nearest_monsters(const Pos2D &center, int count) const
+{
+    return this->monsters.find_nearest(center, count);
+}
+
+std::vector<short> FloorSpatialIndex::find_items(const Rect2D &area) const
+{
+    const auto clipped_area = this->clip(area);
+    return clipped_area ? this->items.find(*clipped_area) : std::vector<short>();
+}
+
+std::vector<short> FloorSpatialIndex::find_items(const Pos2D &center, int radius) const
+{
+    const auto clipped_area = this->clip(Rect2D(center, Pos2DVec(radius, radius)));
+    return clipped_area ? this->items.find(*clipped_area, center, radius) : std::vector<short>();
+}
+
+std::vector<short> FloorSpatialIndex::find_nearest_items(const Pos2D &center, int count) const
+{
+    return this->items.find_nearest(center, count);
+}
+
+/*!
+ * @brief 範囲をフロア内に収める
+ * @param area 範囲
+ * @return フロア内に収めた範囲. フロアと重ならなければstd::nullopt
+ */
+std::optional<Rect2D> FloorSpatialIndex::clip(const Rect2D &area) const
+{
+    const auto top = std::max(area.top_left.y, 0);
+    const auto left = std::max(area.top_left.x, 0);
+    const auto bottom = std::min(area.bottom_right.y, this->height - 1);
+    const auto right = std::min(area.bottom_right.x, this->width - 1);
+    if ((top > bottom) || (left > right)) {
+        return std::nullopt;
+    }
+
+    return Rect2D(Pos2D(top, left), Pos2D(bottom, right));
+}
+
+void FloorSpatialIndex::Layer::reset(int bucket_rows, int bucket_cols)
+{
+    this->bucket_rows = bucket_rows;
+    this->bucket_cols = bucket_cols;
+    this->buckets.assign(bucket_rows * bucket_cols, {});
+    this->bucket_ids.clear();
+    this->positions.clear();
+}
+
+void FloorSpatialIndex::Layer::update(short index, const Pos2D &pos)
+{
+    if (std::cmp_greater_equal(index, this->bucket_ids.size())) {
+        this->bucket_ids.resize(index + 1, -1);
+        this->positions.resize(index + 1, { 0, 0 });
+    }
+
+    const auto bucket_id = this->get_bucket_id(pos);
+    this->positions[index] = pos;
+    if (this->bucket_ids[index] == bucket_id) {
+        return;
+    }
+
+    this->erase_from_bucket(index);
+    this->buckets[bucket_id].push_back(index);
+    this->bucket_ids[index] = bucket_id;
+}
+
+void FloorSpatialIndex::Layer::remove(short index)
+{
+    if (std::cmp_greater_equal(index, this->bucket_ids.size())) {
+        return;
+    }
+
+    this->erase_from_bucket(index);
+    this->bucket_ids[index] = -1;
+}
+
+std::vector<short> FloorSpatialIndex::Layer::find(const Rect2D &area) const
+{
+    std::vector<short> indices;
+    this->for_each_in(area, [&indices](short index, const Pos2D &) {
+        indices.push_back(index);
+    });
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+std::vector<short> FloorSpatialIndex::Layer::find(const Rect2D &area, const Pos2D &center, int radius) const
+{
+    std::vector<short> indices;
+    this->for_each_in(area, [&indices, &center, radius](short index, const Pos2D &pos) {
+        if (distance(center.y, center.x, pos.y, pos.x) <= radius) {
+            indices.push_back(index);
+        }
+    });
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+/*!
+ * @brief 中心のバケットから外側へ1周ずつバケットを調べ、近い順に count 個を返す
+ * @details
+ * 調べ終えたバケット群が中心から覆っているChebyshev距離以内の候補が count 個集まれば打ち切る.
+ * distance() はChebyshev距離以上なので、それより遠いバケットにより近いものが残っていることはない.
+ */
+std::vector<short> FloorSpatialIndex::Layer::find_nearest(const Pos2D &center, int count) const
+{
+    if ((count <= 0) || this->buckets.empty()) {
+        return {};
+    }
+
+    const auto center_row = std::clamp(center.y / BUCKET_SIZE, 0, this->bucket_rows - 1);
+    const auto center_col = std::clamp(center.x / BUCKET_SIZE, 0, this->bucket_cols - 1);
+    const auto margin_top = center.y - center_row * BUCKET_SIZE;
+    const auto margin_left = center.x - center_col * BUCKET_SIZE;
+    const auto inner_margin = std::max(0, std::min({ margin_top, margin_left, BUCKET_SIZE - 1 - margin_top, BUCKET_SIZE - 1 - margin_left }));
+    const auto max_ring = std::max(this->bucket_rows, this->bucket_cols);
+
+    std::vector<std::pair<int, short>> candidates;
+    for (auto ring = 0; ring <= max_ring; ring++) {
+        for (auto row = center_row - ring; row <= center_row + ring; row++) {
+            if ((row < 0) || (row >= this->bucket_rows)) {
+                continue;
+            }
+
+            const auto is_edge_row = (row == center_row - ring) || (row == center_row + ring);
+            const auto step = is_edge_row ? 1 : 2 * ring;
+            for (auto col = center_col - ring; col <= center_col + ring; col += std::max(step, 1)) {
+                if ((col < 0) || (col >= this->bucket_cols)) {
+                    continue;
+                }
+
+                for (const auto index : this->buckets[row * this->bucket_cols + col]) {
+                    const auto &pos = this->positions[index];
+                    candidates.emplace_back(distance(center.y, center.x, pos.y, pos.x), index);
+                }
+            }
+        }
+
+        const auto covered_distance = ring * BUCKET_SIZE + inner_margin;
+        const auto num_covered = std::count_if(candidates.begin(), candidates.end(), [covered_distance](const auto &candidate) {
+            return candidate.first <= covered_distance;
+        });
+        if (num_covered >= count) {
+            break;
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    if (std::cmp_greater(candidates.size(), count)) {
+        candidates.resize(count);
+    }
+
+    std::vector<short> indices;
+    for (const auto &[_, index] : candidates) {
+        indices.push_back(index);
+    }
+
+    return indices;
+}
+
+int FloorSpatialIndex::Layer::get_bucket_id(const Pos2D &pos) const
+{
+    const auto row = std::clamp(pos.y / BUCKET_SIZE, 0, this->bucket_rows - 1);
+    const auto col = std::clamp(pos.x / BUCKET_SIZE, 0, this->bucket_cols - 1);
+    return row * this->bucket_cols + col;
+}
+
+void FloorSpatialIndex::Layer::erase_from_bucket(short index)
+{
+    const auto bucket_id = this->bucket_ids[index];
+    if (bucket_id < 0) {
+        return;
+    }
+
+    auto &bucket = this->buckets[bucket_id];
+    const auto it = std::find(bucket.begin(), bucket.end(), index);
+    if (it != bucket.end()) {
+        *it = bucket.back();
+        bucket.pop_back();
+    }
+}
+
+/*!
+ * @brief 範囲内にある全要素について関数を呼び出す
+ * @param area 範囲 (フロア内に収まっていること)
+ * @param f 要素番号と座標を引数に取る関数
+ */
+template <typename F>
+void FloorSpatialIndex::Layer::for_each_in(const Rect2D &area, F &&f) const
+{
+    if (this->buckets.empty()) {
+        return;
+    }
+
+    const auto top = this->get_bucket_id(area.top_left) / this->bucket_cols;
+    const auto left = this->get_bucket_id(area.top_left) % this->bucket_cols;
+    const auto bottom = this->get_bucket_id(area.bottom_right) / this->bucket_cols;
+    const auto right = this->get_bucket_id(area.bottom_right) % this->bucket_cols;
+    for (auto row = top; row <= bottom; row++) {
+        for (auto col = left; col <= right; col++) {
+            for (const auto index : this->buckets[row * this->bucket_cols + col]) {
+                const auto &pos = this->positions[index];
+                const auto is_inside = (pos.y >= area.top_left.y) && (pos.y <= area.bottom_right.y) && (pos.x >= area.top_left.x) && (pos.x <= area.bottom_right.x);
+                if (is_inside) {
+                    f(index, pos);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "util/point-2d.h"
+#include <optional>
+#include <vector>
+
+/*!
+ * @brief フロア上のモンスターと床上アイテムの位置索引
+ * @details
+ * フロアを BUCKET_SIZE 四方のバケットに区切り、バケット毎にその中にいるモンスター/アイテムの要素番号を保持する.
+ * 範囲検索はフロアのマスではなく範囲に掛かるバケットだけを走査するので、範囲の広さではなく該当数に比例した時間で済む.
+ * モンスターの移動・生成・削除、アイテムの落下・拾得・削除の度に更新する必要がある.
+ * 検索結果は常に要素番号の昇順で返す.
+ */
+class FloorSpatialIndex {
+public:
+    FloorSpatialIndex() = default;
+
+    void reset(int height, int width);
+    void update_monster(short m_idx, const Pos2D &pos);
+    void remove_monster(short m_idx);
+    void update_item(short item_idx, const Pos2D &pos);
+    void remove_item(short item_idx);
+
+    std::vector<short> find_monsters(const Rect2D &area) const;
+    std::vector<short> find_monsters(const Pos2D &center, int radius) const;
+    std::vector<short> find_nearest_monsters(const Pos2D &center, int count) const;
+    std::vector<short> find_items(const Rect2D &area) const;
+    std::vector<short> find_items(const Pos2D &center, int radius) const;
+    std::vector<short> find_nearest_items(const Pos2D &center, int count) const;
+
+private:
+    static constexpr int BUCKET_SIZE = 8;
+
+    /*!
+     * @brief 1種類の要素 (モンスター or アイテム) の索引
+     */
+    class Layer {
+    public:
+        void reset(int bucket_rows, int bucket_cols);
+        void update(short index, const Pos2D &pos);
+        void remove(short index);
+        std::vector<short> find(const Rect2D &area) const;
+        std::vector<short> find(const Rect2D &area, const Pos2D &center, int radius) const;
+        std::vector<short> find_nearest(const Pos2D &center, int count) const;
+
+    private:
+        int bucket_rows = 0;
+        int bucket_cols = 0;
+        std::vector<std::vector<short>> buckets; //!< バケット毎の要素番号
+        std::vector<int> bucket_ids; //!< 要素番号毎の所属バケット (索引に無ければ-1)
+        std::vector<Pos2D> positions; //!< 要素番号毎の座標
+
+        int get_bucket_id(const Pos2D &pos) const;
+        void erase_from_bucket(short index);
+        template <typename F>
+        void for_each_in(const Rect2D &area, F &&f) const;
+    };
+
+    int height = 0;
+    int width = 0;
+    Layer monsters;
+    Layer items;
+
+    std::optional<Rect2D> clip(const Rect2D &area) const;
+};
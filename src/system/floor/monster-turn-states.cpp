@@ -0,0 +1,81 @@
+#include "system/floor/monster-turn-states.h"
+#include "system/gamevalue.h"
+#include "system/monster-entity.h"
+#include <algorithm>
+#include <utility>
+
+void MonsterTurnStates::reset()
+{
+    this->valid_flags.clear();
+    this->distances.clear();
+}
+
+/*!
+ * @brief モンスターの状態を複製し直す
+ * @param m_idx モンスターID
+ * @param monster モンスター
+ */
+void MonsterTurnStates::update(short m_idx, const MonsterEntity &monster)
+{
+    this->reserve_index(m_idx);
+    this->valid_flags[m_idx] = monster.is_valid() ? 1 : 0;
+    this->distances[m_idx] = monster.cdis;
+}
+
+void MonsterTurnStates::remove(short m_idx)
+{
+    if (std::cmp_greater_equal(m_idx, this->valid_flags.size())) {
+        return;
+    }
+
+    this->valid_flags[m_idx] = 0;
+}
+
+void MonsterTurnStates::set_distance(short m_idx, short distance)
+{
+    this->reserve_index(m_idx);
+    this->distances[m_idx] = distance;
+}
+
+bool MonsterTurnStates::is_valid(short m_idx) const
+{
+    return std::cmp_less(m_idx, this->valid_flags.size()) && (this->valid_flags[m_idx] != 0);
+}
+
+/*!
+ * @brief モンスターがプレイヤーを感知し得る距離にいるかを返す
+ * @param m_idx モンスターID
+ * @return 感知範囲内ならtrue
+ */
+bool MonsterTurnStates::is_in_sensing_range(short m_idx) const
+{
+    return std::cmp_less(m_idx, this->distances.size()) && (this->distances[m_idx] < MAX_MONSTER_SENSING);
+}
+
+/*!
+ * @brief 存在するモンスターのIDを降順に列挙する
+ * @param m_max モンスター配列の使用中の長さ
+ * @return モンスターIDのリスト
+ */
+std::vector<short> MonsterTurnStates::collect_valid_indices(short m_max) const
+{
+    std::vector<short> indices;
+    const auto size = std::min<int>(m_max, this->valid_flags.size());
+    for (auto m_idx = size - 1; m_idx >= 1; m_idx--) {
+        if (this->valid_flags[m_idx] != 0) {
+            indices.push_back(static_cast<short>(m_idx));
+        }
+    }
+
+    return indices;
+}
+
+void MonsterTurnStates::reserve_index(short m_idx)
+{
+    if (std::cmp_less(m_idx, this->valid_flags.size())) {
+        return;
+    }
+
+    this->valid_flags.resize(m_idx + 1, 0);
+    this->distances.resize(m_idx + 1, MAX_MONSTER_SENSING);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class MonsterEntity;
+
+/*!
+ * @brief ターン処理で全モンスターについて毎ゲームターン参照する値をモンスターID順に詰めて保持する
+ * @details
+ * MonsterEntity は大きいため、行動するモンスターを探すために全モンスターを走査すると1体毎にキャッシュミスが起こる.
+ * 存在するか否かとプレイヤーからの距離だけをここに複製しておき、感知範囲外のモンスターは MonsterEntity に触れずに読み飛ばす.
+ * モンスターの生成・削除・再配置と、cdis の更新の度に同期する必要がある.
+ */
+class MonsterTurnStates {
+public:
+    MonsterTurnStates() = default;
+
+    void reset();
+    void update(short m_idx, const MonsterEntity &monster);
+    void remove(short m_idx);
+    void set_distance(short m_idx, short distance);
+
+    bool is_valid(short m_idx) const;
+    bool is_in_sensing_range(short m_idx) const;
+    std::vector<short> collect_valid_indices(short m_max) const;
+
+private:
+    std::vector<uint8_t> valid_flags; //!< モンスターID毎の生存フラグ
+    std::vector<short> distances; //!< モンスターID毎のプレイヤーからの距離 (cdisの複製)
+
+    void reserve_index(short m_idx);
+};
@@ -2,19 +2,11 @@
 #include "monster/monster-util.h"
 #include "room/door-definition.h"
 #include "system/angband-system.h"
-#include "system/enums/grid-flow.h"
 #include "system/terrain/terrain-definition.h"
 #include "system/terrain/terrain-list.h"
+#include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
 
-Grid::Grid()
-{
-    for (const auto gf : GRID_FLOW_RANGE) {
-        this->costs[gf] = 0;
-        this->dists[gf] = 0;
-    }
-}
-
 short Grid::get_terrain_id(TerrainKind tk) const
 {
     switch (tk) {
@@ -133,12 +125,12 @@ bool Grid::has_monster() const
 
 uint8_t Grid::get_cost(GridFlow gf) const
 {
-    return this->costs.at(gf);
+    return this->costs[enum2i(gf)];
 }
 
 uint8_t Grid::get_distance(GridFlow gf) const
 {
-    return this->dists.at(gf);
+    return this->dists[enum2i(gf)];
 }
 
 /*
@@ -168,16 +160,12 @@ bool Grid::is_symbol(const int ch) const
 
 void Grid::reset_costs()
 {
-    for (const auto gf : GRID_FLOW_RANGE) {
-        this->costs[gf] = 0;
-    }
+    this->costs.fill(0);
 }
 
 void Grid::reset_dists()
 {
-    for (const auto gf : GRID_FLOW_RANGE) {
-        this->dists[gf] = 0;
-    }
+    this->dists.fill(0);
 }
 
 bool Grid::has_los() const
@@ -223,6 +211,7 @@ const TerrainType &Grid::get_terrain(TerrainKind tk) const
 void Grid::place_closed_curtain()
 {
     this->feat = feat_door[DOOR_CURTAIN].closed;
+    ProjectionPathCache::get_instance().invalidate();
     this->info &= ~(CAVE_MASK);
 }
 
@@ -236,14 +225,20 @@ void Grid::add_info(int grid_info)
     this->info |= grid_info;
 }
 
+/*!
+ * @brief 地形を変える
+ * @param terrain_id 地形ID
+ * @details 経路が変わり得るので ProjectionPathCache を破棄する.
+ */
 void Grid::set_terrain_id(short terrain_id)
 {
     this->feat = terrain_id;
+    ProjectionPathCache::get_instance().invalidate();
 }
 
 void Grid::set_terrain_id(TerrainTag tag)
 {
-    this->feat = TerrainList::get_instance().get_terrain_id(tag);
+    this->set_terrain_id(TerrainList::get_instance().get_terrain_id(tag));
 }
 
 void Grid::set_mimic_terrain_id(TerrainTag tag)
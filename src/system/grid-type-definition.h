@@ -2,7 +2,9 @@
 
 #include "object/object-index-list.h"
 #include "system/angband.h"
-#include <map>
+#include "system/enums/grid-flow.h"
+#include "util/enum-converter.h"
+#include <array>
 
 /*
  * 特殊なマス状態フラグ / Special grid flags
@@ -45,13 +47,12 @@ enum class TerrainKind {
     MIMIC_RAW, //!< 見た目と中身が違う特性の内、隠しドアや罠の方.
 };
 
-enum class GridFlow : int;
 enum class TerrainCharacteristics;
 enum class TerrainTag;
 class TerrainType;
 class Grid {
 public:
-    Grid();
+    Grid() = default;
     BIT_FLAGS info{}; /* Hack -- grid flags */
 
     FEAT_IDX feat{}; /* Hack -- feature type */
@@ -67,8 +68,8 @@ public:
 
     FEAT_IDX mimic{}; /* Feature to mimic */
 
-    std::map<GridFlow, uint8_t> costs; //!< Cost of flowing
-    std::map<GridFlow, uint8_t> dists; //!< Distance from player
+    std::array<uint8_t, enum2i(GridFlow::MAX)> costs{}; //!< Cost of flowing (GridFlowで引く)
+    std::array<uint8_t, enum2i(GridFlow::MAX)> dists{}; //!< Distance from player (GridFlowで引く)
     byte when{}; /* Hack -- when cost was computed */
 
     short get_terrain_id(TerrainKind tk = TerrainKind::NORMAL) const;
@@ -838,7 +838,37 @@ ArtifactType &ItemEntity::get_fixed_artifact() const
     return ArtifactList::get_instance().get_artifact(this->fa_id);
 }
 
+/*!
+ * @brief アイテムの特性フラグを返す
+ * @return エゴ・アーティファクト・鍛冶による効果を合わせた特性フラグ
+ * @details 結果はアイテム毎にキャッシュし、依存する値が変わらない限り再計算しない.
+ */
 TrFlags ItemEntity::get_flags() const
+{
+    auto &cache = this->get_flags_cache();
+    if (!cache.flags) {
+        cache.flags = this->calc_flags();
+    }
+
+    return *cache.flags;
+}
+
+/*!
+ * @brief アイテムの特性フラグのうち、プレイヤーが知っているものを返す
+ * @return 鑑定状況に応じた特性フラグ
+ * @details get_flags() と同じくキャッシュする.
+ */
+TrFlags ItemEntity::get_flags_known() const
+{
+    auto &cache = this->get_flags_cache();
+    if (!cache.flags_known) {
+        cache.flags_known = this->calc_flags_known();
+    }
+
+    return *cache.flags_known;
+}
+
+TrFlags ItemEntity::calc_flags() const
 {
     const auto &baseitem = this->get_baseitem();
     auto flags = baseitem.flags;
@@ -866,7 +896,7 @@ TrFlags ItemEntity::get_flags() const
     return flags;
 }
 
-TrFlags ItemEntity::get_flags_known() const
+TrFlags ItemEntity::calc_flags_known() const
 {
     TrFlags flags{};
     if (!this->is_aware()) {
@@ -1405,6 +1435,31 @@ void ItemEntity::absorb(ItemEntity &other)
         this->pval += other.pval * (other.number - diff) / other.number;
     }
 }
+
+/*!
+ * @brief 特性フラグのキャッシュを返す
+ * @details 特性フラグが依存する値がキャッシュした時から変わっていれば、キャッシュを空にしてから返す.
+ */
+ItemEntity::FlagsCache &ItemEntity::get_flags_cache() const
+{
+    FlagsCacheKey key{
+        .bi_id = this->bi_id,
+        .fa_id = this->fa_id,
+        .ego_idx = this->ego_idx,
+        .is_fuel_empty = this->fuel == 0,
+        .ident = this->ident,
+        .is_aware = this->is_aware(),
+        .smith_effect = this->smith_effect,
+        .smith_act_idx = this->smith_act_idx,
+        .art_flags = this->art_flags,
+    };
+    if (!this->flags_cache || (this->flags_cache->key != key)) {
+        this->flags_cache = FlagsCache{ .key = std::move(key), .flags = std::nullopt, .flags_known = std::nullopt };
+    }
+
+    return *this->flags_cache;
+}
+
 /*!
  * @brief エゴ光源のフラグを修正する
  *
@@ -180,9 +180,40 @@ public:
     void absorb(ItemEntity &other);
 
 private:
+    /*!
+     * @brief get_flags() / get_flags_known() の結果が依存する値の組
+     * @details 計算時の値と一致する限りキャッシュを使う. いずれかのメンバが直接書き換えられれば一致しなくなるので、
+     * エゴ/アーティファクト化・鍛冶・鑑定・ベースアイテムの認識のどれが起きても自動的に計算し直される.
+     */
+    struct FlagsCacheKey {
+        short bi_id;
+        FixedArtifactId fa_id;
+        EgoType ego_idx;
+        bool is_fuel_empty;
+        byte ident;
+        bool is_aware;
+        std::optional<SmithEffectType> smith_effect;
+        std::optional<RandomArtActType> smith_act_idx;
+        TrFlags art_flags;
+
+        bool operator==(const FlagsCacheKey &other) const = default;
+    };
+
+    struct FlagsCache {
+        FlagsCacheKey key;
+        std::optional<TrFlags> flags;
+        std::optional<TrFlags> flags_known;
+    };
+
+    mutable std::optional<FlagsCache> flags_cache; //!< 特性フラグのキャッシュ (最初に問い合わせるまで計算しない)
+
     ItemEntity(const ItemEntity &) = default;
     ItemEntity &operator=(const ItemEntity &) = default;
 
+    FlagsCache &get_flags_cache() const;
+    TrFlags calc_flags() const;
+    TrFlags calc_flags_known() const;
+
     int get_baseitem_price() const;
     int calc_figurine_value() const;
     int calc_capture_value() const;
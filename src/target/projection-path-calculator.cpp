@@ -9,6 +9,7 @@
 #include "system/grid-type-definition.h"
 #include "system/player-type-definition.h"
 #include "util/bit-flags-calculator.h"
+#include "world/world.h"
 
 class ProjectionPathHelper {
 public:
@@ -251,6 +252,50 @@ ProjectionPath::ProjectionPath(PlayerType *player_ptr, int range, const Pos2D &p
     calc_diagonal_projection(player_ptr, &pph);
 }
 
+ProjectionPathCache ProjectionPathCache::instance{};
+
+ProjectionPathCache &ProjectionPathCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 始点から終点への直線経路をキャッシュから返す
+ * @details 引数はProjectionPathのコンストラクタと同じ. キャッシュに無ければ計算して保持する.
+ * フロアの生成中は地形が直接書き換えられるので、キャッシュを使わない.
+ * @return 経路. 次に get() か invalidate() を呼ぶまで有効なので、地形を変えながら経路を辿る呼び出し元はコピーすること
+ */
+const ProjectionPath &ProjectionPathCache::get(PlayerType *player_ptr, int range, const Pos2D &pos_src, const Pos2D &pos_dst, uint32_t flag)
+{
+    const auto &world = AngbandWorld::get_instance();
+    if (any_bits(flag, PROJECT_STOP | PROJECT_MIRROR) || !world.character_dungeon) {
+        return this->uncached_path.emplace(player_ptr, range, pos_src, pos_dst, flag);
+    }
+
+    const auto game_turn = world.game_turn;
+    if ((this->game_turn != game_turn) || (this->paths.size() >= MAX_ENTRIES)) {
+        this->invalidate();
+        this->game_turn = game_turn;
+    }
+
+    const Key key(range, pos_src.y, pos_src.x, pos_dst.y, pos_dst.x, flag);
+    const auto it = this->paths.find(key);
+    if (it != this->paths.end()) {
+        return it->second;
+    }
+
+    return this->paths.emplace(key, ProjectionPath(player_ptr, range, pos_src, pos_dst, flag)).first->second;
+}
+
+/*!
+ * @brief キャッシュを破棄する
+ * @details 地形を変更したらその場で呼ぶこと.
+ */
+void ProjectionPathCache::invalidate()
+{
+    this->paths.clear();
+}
+
 /*
  * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
  * at the final destination, assuming no monster gets in the way.
@@ -259,7 +304,8 @@ ProjectionPath::ProjectionPath(PlayerType *player_ptr, int range, const Pos2D &p
  */
 bool projectable(PlayerType *player_ptr, const Pos2D &pos1, const Pos2D &pos2)
 {
-    ProjectionPath grid_g(player_ptr, (project_length ? project_length : AngbandSystem::get_instance().get_max_range()), pos1, pos2, 0);
+    const auto range = project_length ? project_length : AngbandSystem::get_instance().get_max_range();
+    const auto &grid_g = ProjectionPathCache::get_instance().get(player_ptr, range, pos1, pos2, 0);
     if (grid_g.path_num() == 0) {
         return true;
     }
@@ -2,6 +2,9 @@
 
 #include "util/point-2d.h"
 #include <cstdint>
+#include <map>
+#include <optional>
+#include <tuple>
 #include <vector>
 
 class PlayerType;
@@ -21,4 +24,36 @@ private:
     std::vector<Pos2D> position;
 };
 
+/*!
+ * @brief 射撃・魔法の経路を同一ゲームターン内で使い回すためのキャッシュ
+ * @details
+ * 経路は始点・終点・射程・フラグと地形だけで決まるので、同じゲームターン内に地形が変わらなければ同じ結果になる.
+ * モンスターの魔法選択 (直線が届くかの判定) と実際の発動とで同じ経路を何度も計算しないよう保持しておく.
+ * ゲームターンが進んだ時・フロアが変わった時・地形が変わった時に破棄する.
+ * フロアの生成中は地形を直接書き換えるので、生成中は経路をキャッシュしない.
+ * モンスターやプレイヤーの位置に依存する PROJECT_STOP と、鏡の配置に依存する PROJECT_MIRROR の経路はキャッシュしない.
+ */
+class ProjectionPathCache {
+public:
+    ProjectionPathCache(const ProjectionPathCache &) = delete;
+    ProjectionPathCache(ProjectionPathCache &&) = delete;
+    ProjectionPathCache &operator=(const ProjectionPathCache &) = delete;
+    ProjectionPathCache &operator=(ProjectionPathCache &&) = delete;
+
+    static ProjectionPathCache &get_instance();
+    const ProjectionPath &get(PlayerType *player_ptr, int range, const Pos2D &pos_src, const Pos2D &pos_dst, uint32_t flag);
+    void invalidate();
+
+private:
+    ProjectionPathCache() = default;
+
+    static constexpr size_t MAX_ENTRIES = 4096;
+    static ProjectionPathCache instance;
+
+    using Key = std::tuple<int, int, int, int, int, uint32_t>;
+    std::map<Key, ProjectionPath> paths;
+    std::optional<ProjectionPath> uncached_path; //!< キャッシュしない経路の計算結果
+    int32_t game_turn = -1;
+};
+
 bool projectable(PlayerType *player_ptr, const Pos2D &pos1, const Pos2D &pos2);
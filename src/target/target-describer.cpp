@@ -515,11 +515,11 @@ static std::string describe_grid_monster_all(GridExamination *ge_ptr)
 
 #ifdef JP
     return format("%s%s%s%s[%s] %x %s %d %d %d (%d,%d) %d", ge_ptr->s1, ge_ptr->name.data(), ge_ptr->s2, ge_ptr->s3, ge_ptr->info,
-        (uint)ge_ptr->g_ptr->info, f_idx_str.data(), ge_ptr->g_ptr->dists[GridFlow::NORMAL], ge_ptr->g_ptr->costs[GridFlow::NORMAL], ge_ptr->g_ptr->when,
+        (uint)ge_ptr->g_ptr->info, f_idx_str.data(), ge_ptr->g_ptr->get_distance(GridFlow::NORMAL), ge_ptr->g_ptr->get_cost(GridFlow::NORMAL), ge_ptr->g_ptr->when,
         ge_ptr->y, ge_ptr->x, travel.cost[ge_ptr->y][ge_ptr->x]);
 #else
     return format("%s%s%s%s [%s] %x %s %d %d %d (%d,%d)", ge_ptr->s1, ge_ptr->s2, ge_ptr->s3, ge_ptr->name.data(), ge_ptr->info, ge_ptr->g_ptr->info,
-        f_idx_str.data(), ge_ptr->g_ptr->dists[GridFlow::NORMAL], ge_ptr->g_ptr->costs[GridFlow::NORMAL], ge_ptr->g_ptr->when, ge_ptr->y, ge_ptr->x);
+        f_idx_str.data(), ge_ptr->g_ptr->get_distance(GridFlow::NORMAL), ge_ptr->g_ptr->get_cost(GridFlow::NORMAL), ge_ptr->g_ptr->when, ge_ptr->y, ge_ptr->x);
 #endif
 }
 
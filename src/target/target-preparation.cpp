@@ -21,6 +21,7 @@
 #include "util/bit-flags-calculator.h"
 #include "window/main-window-util.h"
 #include <algorithm>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -109,6 +110,37 @@ static bool target_set_accept(PlayerType *player_ptr, const Pos2D &pos)
     return grid.get_terrain(TerrainKind::MIMIC).flags.has(TerrainCharacteristics::NOTICE);
 }
 
+/*!
+ * @brief 範囲内で攻撃対象にできるモンスターの座標を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param area 範囲
+ * @return モンスターの座標のリスト (行優先の順)
+ * @details 攻撃対象はモンスターのいるマスに限られるので、マスを走査せず位置索引から候補を得る.
+ */
+static std::vector<Pos2D> collect_killable_positions(PlayerType *player_ptr, const Rect2D &area)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    std::vector<Pos2D> pos_list;
+    for (const auto m_idx : floor.spatial_index.find_monsters(area)) {
+        const auto &monster = floor.m_list[m_idx];
+        const auto pos = monster.get_position();
+        if (!in_bounds(&floor, pos.y, pos.x) || !target_able(player_ptr, m_idx)) {
+            continue;
+        }
+
+        if (!target_pet && monster.is_pet()) {
+            continue;
+        }
+
+        pos_list.push_back(pos);
+    }
+
+    std::sort(pos_list.begin(), pos_list.end(), [](const auto &a, const auto &b) {
+        return std::tie(a.y, a.x) < std::tie(b.y, b.x);
+    });
+    return pos_list;
+}
+
 /*!
  * @brief "interesting" な座標たちを ys, xs に返す。
  * @param player_ptr
@@ -137,24 +169,16 @@ void target_set_prepare(PlayerType *player_ptr, std::vector<POSITION> &ys, std::
     }
 
     std::vector<Pos2D> pos_list;
-    for (auto y = min_hgt; y <= max_hgt; y++) {
-        for (auto x = min_wid; x <= max_wid; x++) {
-            const Pos2D pos(y, x);
-            if (!target_set_accept(player_ptr, pos)) {
-                continue;
-            }
-
-            const auto &grid = floor.get_grid(pos);
-            if ((mode & (TARGET_KILL)) && !target_able(player_ptr, grid.m_idx)) {
-                continue;
-            }
-
-            const auto &monster = floor.m_list[grid.m_idx];
-            if ((mode & (TARGET_KILL)) && !target_pet && monster.is_pet()) {
-                continue;
+    if (is_killable) {
+        pos_list = collect_killable_positions(player_ptr, { Pos2D(min_hgt, min_wid), Pos2D(max_hgt, max_wid) });
+    } else {
+        for (auto y = min_hgt; y <= max_hgt; y++) {
+            for (auto x = min_wid; x <= max_wid; x++) {
+                const Pos2D pos(y, x);
+                if (target_set_accept(player_ptr, pos)) {
+                    pos_list.push_back(pos);
+                }
             }
-
-            pos_list.push_back(pos);
         }
     }
 
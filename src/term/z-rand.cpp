@@ -67,6 +67,31 @@ void Rand_state_init(void)
     AngbandSystem::get_instance().get_rng().set_state(state);
 }
 
+/*!
+ * @brief シードで初期化した乱数ストリームを束縛する
+ * @param seed 乱数シード
+ */
+RngStreamScope::RngStreamScope(uint32_t seed)
+    : RngStreamScope(Xoshiro128StarStar(seed))
+{
+}
+
+/*!
+ * @brief 指定した状態の乱数ストリームを束縛する
+ * @param rng 束縛する乱数生成器 (コピーして使う)
+ */
+RngStreamScope::RngStreamScope(const Xoshiro128StarStar &rng)
+    : rng(rng)
+    , previous_rng(AngbandSystem::bound_rng)
+{
+    AngbandSystem::bound_rng = &this->rng;
+}
+
+RngStreamScope::~RngStreamScope()
+{
+    AngbandSystem::bound_rng = this->previous_rng;
+}
+
 int rand_range(int a, int b)
 {
     if (a >= b) {
@@ -113,6 +113,28 @@ bool one_in_(T n)
     return randint0(static_cast<int>(n)) == 0;
 }
 
+/*!
+ * @brief 乱数ストリームを現在のスレッドに束縛するクラス
+ * @details
+ * 生存期間中、このスレッドの randint0() 等の乱数は全てこのオブジェクトが持つ乱数生成器から取り出される.
+ * 入れ子にでき、破棄されると1つ外側のストリームに戻る. ゲーム本体の乱数列には一切影響しない.
+ * ワーカースレッドで乱数を使う場合は、Xoshiro128StarStar::split() で切り出したストリームを必ず束縛すること.
+ */
+class RngStreamScope {
+public:
+    explicit RngStreamScope(uint32_t seed);
+    explicit RngStreamScope(const Xoshiro128StarStar &rng);
+    ~RngStreamScope();
+    RngStreamScope(const RngStreamScope &) = delete;
+    RngStreamScope(RngStreamScope &&) = delete;
+    RngStreamScope &operator=(const RngStreamScope &) = delete;
+    RngStreamScope &operator=(RngStreamScope &&) = delete;
+
+private:
+    Xoshiro128StarStar rng;
+    Xoshiro128StarStar *previous_rng;
+};
+
 void Rand_state_init();
 int16_t randnor(int mean, int stand);
 int32_t div_round(int32_t n, int32_t d);
@@ -0,0 +1,213 @@
+/*!
+ * @brief 画面の中継配信サーバのテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -I. -DHAVE_SYS_EPOLL_H -pthread test/test-chuukei-server.cpp io/chuukei-server.cpp io/movie-file.cpp util/angband-files.cpp util/string-processor.cpp locale/japanese.cpp locale/utf-8.cpp main-unix/stack-trace-unix.cpp system/angband-version.cpp term/z-form.cpp term/z-util.cpp
+ *
+ * Unixドメインソケットで待ち受けたサーバに観戦者として接続し、ヘッダ・追い付き用のフレーム・配信したフレームが
+ * 届かなければassertでプログラムが停止する.
+ * ファイル記述子が尽きて受け付けられない間にイベントループが空回りしないことも確かめる.
+ */
+
+#include "io/chuukei-server.h"
+#include "io/movie-file.h"
+#include "util/angband-files.h"
+
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+constexpr auto FRAME_HEADER_SIZE = 9;
+
+/*!
+ * @brief 観戦者として接続する
+ * @param path サーバのソケットのパス
+ * @return 接続したソケット
+ */
+int connect_client(const std::filesystem::path &path)
+{
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    const timeval timeout{ .tv_sec = 5, .tv_usec = 0 };
+    assert(setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const auto path_str = path.string();
+    std::copy(path_str.begin(), path_str.end(), addr.sun_path);
+    assert(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+/*!
+ * @brief 指定したバイト数を受信する
+ * @details 5秒待っても届かなければassertで停止する.
+ */
+std::string receive(int fd, size_t size)
+{
+    std::string received(size, '\0');
+    size_t offset = 0;
+    while (offset < size) {
+        const auto n = recv(fd, received.data() + offset, size - offset, 0);
+        assert(n > 0);
+        offset += n;
+    }
+
+    return received;
+}
+
+/*!
+ * @brief フレームを1つ受信し、送った内容と一致するか確かめる
+ */
+void check_frame(int fd, const MovieFrame &expected)
+{
+    const auto header = receive(fd, FRAME_HEADER_SIZE);
+    assert(header[0] == (expected.is_keyframe ? 'K' : 'D'));
+    const auto payload = receive(fd, expected.payload.length());
+    std::string encoded;
+    append_movie_frame(encoded, expected.is_keyframe, expected.time, expected.payload);
+    assert(header + payload == encoded);
+}
+
+void check_header(int fd)
+{
+    const auto header = get_movie_file_header();
+    assert(receive(fd, header.length()) == header);
+}
+
+MovieFrame make_frame(bool is_keyframe, uint32_t time)
+{
+    const auto text = std::to_string(time);
+    auto payload = make_movie_record('t', { 0, 1, static_cast<int>(text.length()), 0 });
+    payload.append(text);
+    payload.append(make_movie_record('x', { 0 }));
+    return { is_keyframe, time, payload };
+}
+
+void broadcast(ChuukeiServer &server, const MovieFrame &frame)
+{
+    server.broadcast(frame.is_keyframe, frame.time, frame.payload);
+}
+
+/*!
+ * @brief 受信待ちのデータが無いことを確かめる
+ */
+void check_no_data(int fd)
+{
+    char c;
+    assert(recv(fd, &c, 1, MSG_DONTWAIT) < 0);
+}
+
+double get_cpu_seconds()
+{
+    rusage usage{};
+    (void)getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+/*!
+ * @brief ファイル記述子が尽きている間に接続した観戦者も、空きができたら受け付けられることを確かめる
+ */
+void test_descriptor_exhaustion(ChuukeiServer &server, const std::filesystem::path &path, const MovieFrame &keyframe)
+{
+    rlimit original{};
+    assert(getrlimit(RLIMIT_NOFILE, &original) == 0);
+
+    /* 使用中の記述子より大きい番号を禁じ、サーバが accept できないようにする */
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    const auto lowest_free = dup(fd);
+    assert(lowest_free >= 0);
+    close(lowest_free);
+    rlimit exhausted = original;
+    exhausted.rlim_cur = lowest_free;
+    assert(setrlimit(RLIMIT_NOFILE, &exhausted) == 0);
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const auto path_str = path.string();
+    std::copy(path_str.begin(), path_str.end(), addr.sun_path);
+    assert(connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+
+    const auto start = get_cpu_seconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    assert(get_cpu_seconds() - start < 0.1);
+    check_no_data(fd);
+
+    assert(setrlimit(RLIMIT_NOFILE, &original) == 0);
+    const timeval timeout{ .tv_sec = 5, .tv_usec = 0 };
+    assert(setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0);
+    const auto frame = make_frame(false, keyframe.time + 1);
+    broadcast(server, frame);
+    check_header(fd);
+    check_frame(fd, keyframe);
+    check_frame(fd, frame);
+    close(fd);
+}
+}
+
+int main()
+{
+    const auto path = std::filesystem::temp_directory_path() / "test-chuukei-server.sock";
+    const auto address = "unix:" + path.string();
+
+    /* ソケット以外のファイルは消さずに失敗する */
+    std::filesystem::remove(path);
+    fd_close(fd_make(path));
+    assert(!ChuukeiServer::listen(address));
+    assert(std::filesystem::is_regular_file(path));
+    std::filesystem::remove(path);
+
+    auto server = ChuukeiServer::listen(address);
+    assert(server);
+
+    /* 接続前に配信したキーフレームと差分は、接続時に追い付き用として届く */
+    const std::vector<MovieFrame> frames{ make_frame(true, 0), make_frame(false, 5) };
+    for (const auto &frame : frames) {
+        assert(server->is_keyframe_due(frame.time) == frame.is_keyframe);
+        broadcast(*server, frame);
+    }
+
+    const auto client = connect_client(path);
+    check_header(client);
+    for (const auto &frame : frames) {
+        check_frame(client, frame);
+    }
+
+    /* 接続後に配信したフレームはそのまま届く */
+    const auto broadcast_frame = make_frame(false, 10);
+    broadcast(*server, broadcast_frame);
+    check_frame(client, broadcast_frame);
+
+    /* キーフレーム以後に接続した観戦者には、それより前のフレームは届かない */
+    const auto keyframe = make_frame(true, 100);
+    assert(server->is_keyframe_due(keyframe.time));
+    broadcast(*server, keyframe);
+    check_frame(client, keyframe);
+    const auto late_client = connect_client(path);
+    check_header(late_client);
+    check_frame(late_client, keyframe);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    check_no_data(late_client);
+
+    /* 観戦者の切断で記述子が空かないよう、接続したまま試す */
+    test_descriptor_exhaustion(*server, path, keyframe);
+
+    close(late_client);
+    close(client);
+    server.reset();
+    std::filesystem::remove(path);
+    std::cout << "OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*!
+ * @brief 索引付きムービーファイルの読み書きのテストプログラム
+ *
+ * srcディレクトリで以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -I. test/test-movie-file.cpp io/movie-file.cpp util/angband-files.cpp util/string-processor.cpp locale/japanese.cpp locale/utf-8.cpp main-unix/stack-trace-unix.cpp system/angband-version.cpp term/z-form.cpp term/z-util.cpp
+ *
+ * 描画レコードを詰めたフレームを書き込み、読み戻し・索引の再構築・シークの結果が書き込んだ内容と一致しなければassertでプログラムが停止する
+ */
+
+#include "io/movie-file.h"
+#include "util/angband-files.h"
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief 描画レコードの列を先頭から区切る
+ * @return 各レコードの長さ. 区切れなければ空
+ */
+static std::vector<size_t> split_records(std::string_view payload)
+{
+    std::vector<size_t> lengths;
+    while (!payload.empty()) {
+        const auto length = get_movie_record_length(payload);
+        if ((length == 0) || (length > payload.length())) {
+            return {};
+        }
+
+        lengths.push_back(length);
+        payload.remove_prefix(length);
+    }
+
+    return lengths;
+}
+
+/*!
+ * @brief 時刻毎に異なる描画レコードの列を作る
+ * @details 色0 (TERM_DARK) のレコードを必ず含める.
+ */
+static std::string make_payload(uint32_t time)
+{
+    std::string payload;
+    payload.append(make_movie_record('s', { 1, 1, 0, '@' }));
+    payload.append(make_movie_record('n', { 2, 1, 3, 0, '#' }));
+    const auto text = std::to_string(time);
+    payload.append(make_movie_record('t', { 5, 2, static_cast<int>(text.length()), 0 }));
+    payload.append(text);
+    payload.append(make_movie_record('w', { 1, 3, 10 }));
+    payload.append(make_movie_record('c', { 1, 1 }));
+    payload.append(make_movie_record('x', { 0 }));
+    return payload;
+}
+
+static void test_records()
+{
+    const auto payload = make_payload(123);
+    const std::vector<size_t> expected{ 5, 6, 8, 4, 3, 2 };
+    assert(split_records(payload) == expected);
+    assert(payload.length() == 28);
+    assert(payload[3] == '\0');
+}
+
+/*!
+ * @brief 書き込んだ全フレームを読み戻せることと、シークの行き先を確かめる
+ * @param fd 読み込み用に開いたファイル
+ * @param frames 書き込んだフレーム
+ */
+static void check_reader(int fd, const std::vector<MovieFrame> &frames)
+{
+    assert(MovieReader::is_indexed_movie(fd));
+    MovieReader reader(fd);
+    for (const auto &expected : frames) {
+        const auto frame = reader.read_frame();
+        assert(frame);
+        assert(frame->is_keyframe == expected.is_keyframe);
+        assert(frame->time == expected.time);
+        assert(frame->payload == expected.payload);
+        assert(split_records(frame->payload).size() == 6);
+    }
+
+    assert(!reader.read_frame());
+
+    for (const auto &target : frames) {
+        reader.seek(target.time);
+        const auto frame = reader.read_frame();
+        assert(frame && frame->is_keyframe);
+        assert(frame->time <= target.time);
+        assert(target.time - frame->time < 100);
+    }
+
+    reader.seek(0);
+    const auto first = reader.read_frame();
+    assert(first && (first->time == frames.front().time));
+}
+
+int main()
+{
+    test_records();
+
+    const auto path = std::filesystem::temp_directory_path() / "test-movie-file.amv";
+    fd_kill(path);
+    std::vector<MovieFrame> frames;
+    {
+        const auto fd = fd_make(path);
+        assert(fd >= 0);
+        MovieWriter writer(fd);
+        for (uint32_t time = 0; time < 450; time += 7) {
+            const auto is_keyframe = writer.is_keyframe_due(time);
+            frames.push_back({ is_keyframe, time, make_payload(time) });
+            writer.write_frame(is_keyframe, time, frames.back().payload);
+        }
+    }
+
+    assert(std::count_if(frames.begin(), frames.end(), [](const MovieFrame &frame) { return frame.is_keyframe; }) == 5);
+
+    auto fd = fd_open(path, O_RDONLY);
+    assert(fd >= 0);
+    check_reader(fd, frames);
+    (void)fd_close(fd);
+
+    /* 索引の無い、録画中に終了したファイル */
+    const auto full_size = std::filesystem::file_size(path);
+    const auto frame_size = 9 + frames.back().payload.length();
+    const auto data_size = 8 + std::accumulate(frames.begin(), frames.end(), size_t{}, [](size_t sum, const MovieFrame &frame) {
+        return sum + 9 + frame.payload.length();
+    });
+    assert(full_size > data_size);
+    std::filesystem::resize_file(path, data_size);
+    fd = fd_open(path, O_RDONLY);
+    check_reader(fd, frames);
+    (void)fd_close(fd);
+
+    /* 最後のフレームが途中で切れたファイル */
+    std::filesystem::resize_file(path, data_size - frame_size / 2);
+    frames.pop_back();
+    fd = fd_open(path, O_RDONLY);
+    check_reader(fd, frames);
+    (void)fd_close(fd);
+
+    fd_kill(path);
+    std::cout << "OK" << std::endl;
+    return 0;
+}
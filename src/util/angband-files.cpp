@@ -408,6 +408,26 @@ void fd_move(const std::filesystem::path &path_from, const std::filesystem::path
     std::filesystem::rename(abs_path_from, abs_path_to, ec);
 }
 
+/*!
+ * @brief 移動先のファイルを移動元のファイルで不可分に置き換える
+ * @param path_from 移動元のファイルの相対パスまたは絶対パス
+ * @param path_to 置き換えるファイルの相対パスまたは絶対パス
+ * @return 置き換えられたか否か
+ * @details 移動先が他から開かれているとWindowsでは失敗するので、呼び出し側で閉じておくこと.
+ */
+bool fd_replace(const std::filesystem::path &path_from, const std::filesystem::path &path_to)
+{
+    const auto &abs_path_from = path_parse(path_from);
+    const auto &abs_path_to = path_parse(path_to);
+#ifdef WINDOWS
+    return MoveFileExW(abs_path_from.wstring().data(), abs_path_to.wstring().data(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    std::error_code ec;
+    std::filesystem::rename(abs_path_from, abs_path_to, ec);
+    return !ec;
+#endif
+}
+
 /*!
  * @brief OSごとの差異を吸収してファイルを作成する
  * @param path 作成先ファイルの相対パスまたは絶対パス
@@ -435,6 +455,9 @@ int fd_open(const std::filesystem::path &path, int mode)
  * Hack -- attempt to lock a file descriptor
  *
  * Legal lock types -- F_UNLCK, F_RDLCK, F_WRLCK
+ *
+ * Windows locks the whole file with LockFileEx().
+ * Other systems without SET_UID and flock() do not lock at all.
  */
 errr fd_lock(int fd, int what)
 {
@@ -451,6 +474,20 @@ errr fd_lock(int fd, int what)
             return 1;
         }
     }
+#elif defined(WINDOWS)
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 1;
+    }
+
+    OVERLAPPED overlapped{};
+    if (what == F_UNLCK) {
+        (void)UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+    } else {
+        if (!LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+            return 1;
+        }
+    }
 #endif
 
     return 0;
@@ -1,4 +1,5 @@
 #include "util/rng-xoshiro.h"
+#include <span>
 
 namespace {
 
@@ -14,6 +15,30 @@ uint32_t u32b_rotl(uint32_t x, int k)
     return (x << k) | (x >> (32 - k));
 }
 
+/*!
+ * @brief ジャンプ多項式に従って乱数の内部状態を進める
+ *
+ * @param rng 内部状態を進める乱数生成器
+ * @param polynomial ジャンプ多項式
+ */
+void jump_by(Xoshiro128StarStar &rng, std::span<const uint32_t> polynomial)
+{
+    Xoshiro128StarStar::state_type state{};
+    for (const auto bits : polynomial) {
+        for (auto b = 0; b < 32; b++) {
+            if (bits & (1U << b)) {
+                for (size_t i = 0; i < state.size(); ++i) {
+                    state[i] ^= rng.get_state()[i];
+                }
+            }
+
+            rng();
+        }
+    }
+
+    rng.set_state(state);
+}
+
 }
 
 /*!
@@ -99,3 +124,37 @@ const Xoshiro128StarStar::state_type &Xoshiro128StarStar::get_state() const
 {
     return this->rng_state;
 }
+
+/*!
+ * @brief 2^64回分だけ乱数の内部状態を進める
+ * @details 同じ状態から始めた乱数列を、互いに重ならない2^64個ずつのストリームに分割するのに使う.
+ */
+void Xoshiro128StarStar::jump()
+{
+    static constexpr std::array<uint32_t, 4> JUMP = { { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b } };
+    jump_by(*this, JUMP);
+}
+
+/*!
+ * @brief 2^96回分だけ乱数の内部状態を進める
+ * @details jump() で分割したストリーム群を、さらに互いに重ならない組として分けるのに使う.
+ */
+void Xoshiro128StarStar::long_jump()
+{
+    static constexpr std::array<uint32_t, 4> LONG_JUMP = { { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 } };
+    jump_by(*this, LONG_JUMP);
+}
+
+/*!
+ * @brief 現在の状態から始まる乱数ストリームを切り出す
+ * @details 切り出したストリームは元の状態のコピーで、自身は jump() して重ならない位置へ進む.
+ * 同じ状態から同じ順序で切り出せば、常に同じストリーム群が得られる.
+ *
+ * @return 切り出した乱数生成器
+ */
+Xoshiro128StarStar Xoshiro128StarStar::split()
+{
+    auto stream = *this;
+    this->jump();
+    return stream;
+}
@@ -39,6 +39,10 @@ public:
     void set_state(const state_type &state);
     const state_type &get_state() const;
 
+    void jump();
+    void long_jump();
+    Xoshiro128StarStar split();
+
 private:
     state_type rng_state; //!< RNG state
 };
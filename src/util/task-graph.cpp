@@ -0,0 +1,58 @@
+#include "util/task-graph.h"
+#include "system/angband-exceptions.h"
+#include <algorithm>
+#include <future>
+
+/*!
+ * @brief タスクを追加する
+ * @param name タスク名
+ * @param func 処理内容
+ * @param dependencies 依存するタスクの名前 (追加済みのものに限る)
+ */
+void TaskGraph::add(std::string_view name, std::function<void()> func, std::initializer_list<std::string_view> dependencies)
+{
+    Task task{ std::string(name), std::move(func), {} };
+    for (const auto &dependency : dependencies) {
+        const auto it = std::find_if(this->tasks.begin(), this->tasks.end(), [dependency](const auto &t) { return t.name == dependency; });
+        if (it == this->tasks.end()) {
+            THROW_EXCEPTION(std::logic_error, "Unknown dependency task: " + std::string(dependency));
+        }
+
+        task.dependencies.push_back(std::distance(this->tasks.begin(), it));
+    }
+
+    this->tasks.push_back(std::move(task));
+}
+
+/*!
+ * @brief 全てのタスクを実行し、完了するまで待つ
+ * @details タスクが例外を送出した場合、それに依存するタスクは実行されない.
+ * 全てのスレッドが終了してから、最初に追加されたタスクの例外を再送出する.
+ */
+void TaskGraph::run()
+{
+    std::vector<std::shared_future<void>> futures;
+    futures.reserve(this->tasks.size());
+    for (const auto &task : this->tasks) {
+        std::vector<std::shared_future<void>> dependency_futures;
+        for (const auto dependency : task.dependencies) {
+            dependency_futures.push_back(futures[dependency]);
+        }
+
+        futures.push_back(std::async(std::launch::async, [&task, dependency_futures = std::move(dependency_futures)] {
+            for (const auto &dependency_future : dependency_futures) {
+                dependency_future.get();
+            }
+
+            task.func();
+        }).share());
+    }
+
+    for (const auto &future : futures) {
+        future.wait();
+    }
+
+    for (const auto &future : futures) {
+        future.get();
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief 依存関係を持つタスクを並列に実行するクラス
+ * @details
+ * 各タスクは依存する全てのタスクが完了してからワーカースレッドで実行される.
+ * 依存先は先に追加したタスクしか指定できないので、依存関係が循環することはない.
+ */
+class TaskGraph {
+public:
+    TaskGraph() = default;
+
+    void add(std::string_view name, std::function<void()> func, std::initializer_list<std::string_view> dependencies = {});
+    void run();
+
+private:
+    struct Task {
+        std::string name; //!< タスク名
+        std::function<void()> func; //!< 処理内容
+        std::vector<size_t> dependencies; //!< 依存するタスクのインデックス
+    };
+
+    std::vector<Task> tasks;
+};
@@ -21,12 +21,201 @@
 #include "term/screen-processor.h"
 #include "term/term-color-types.h"
 #include "term/z-form.h"
+#include "term/z-term.h"
 #include "tracking/lore-tracker.h"
 #include "util/bit-flags-calculator.h"
 #include "util/string-processor.h"
 #include "view/display-messages.h"
 #include "view/display-symbol.h"
 #include "world/world.h"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <vector>
+
+namespace {
+constexpr auto MAX_LORE_LAYOUTS = 64; //!< 描画結果を保持しておくモンスター種族数の上限
+
+/*!
+ * @brief モンスターの思い出の描画結果を左右する状態
+ * @details モンスターの思い出の各カウンタ・フラグとプレイヤーの状態、描画先の端末の大きさからなる.
+ */
+struct MonsterLoreState {
+    monster_lore_mode mode;
+    bool know_everything;
+    PLAYER_LEVEL lev;
+    PLAYER_LEVEL max_plv;
+    int chp; //!< 破滅の手が既知の時のみ. それ以外では0
+    PlayerClassType pclass;
+    MONSTER_NUMBER max_num;
+    MONSTER_NUMBER r_sights;
+    MONSTER_NUMBER r_deaths;
+    MONSTER_NUMBER r_pkills;
+    MONSTER_NUMBER r_akills;
+    MONSTER_NUMBER r_tkills;
+    byte r_wake;
+    byte r_ignore;
+    bool r_can_evolve;
+    ITEM_NUMBER r_drop_gold;
+    ITEM_NUMBER r_drop_item;
+    byte r_cast_spell;
+    std::array<byte, MAX_NUM_BLOWS> r_blows;
+    EnumClassFlagGroup<MonsterAbilityType> r_ability_flags;
+    EnumClassFlagGroup<MonsterAuraType> r_aura_flags;
+    EnumClassFlagGroup<MonsterBehaviorType> r_behavior_flags;
+    EnumClassFlagGroup<MonsterKindType> r_kind_flags;
+    EnumClassFlagGroup<MonsterResistanceType> r_resistance_flags;
+    EnumClassFlagGroup<MonsterDropType> r_drop_flags;
+    EnumClassFlagGroup<MonsterFeatureType> r_feature_flags;
+    EnumClassFlagGroup<MonsterSpecialType> r_special_flags;
+    EnumClassFlagGroup<MonsterMiscType> r_misc_flags;
+    TERM_LEN term_wid;
+    TERM_LEN term_hgt;
+    std::pair<int, int> size;
+    TERM_LEN offset_x;
+    TERM_LEN offset_y;
+
+    MonsterLoreState(PlayerType *player_ptr, const MonraceDefinition &monrace, monster_lore_mode mode)
+        : mode(mode)
+        , know_everything(cheat_know)
+        , lev(player_ptr->lev)
+        , max_plv(player_ptr->max_plv)
+        , chp(is_hand_doom_known(monrace, mode) ? player_ptr->chp : 0)
+        , pclass(player_ptr->pclass)
+        , max_num(monrace.max_num)
+        , r_sights(monrace.r_sights)
+        , r_deaths(monrace.r_deaths)
+        , r_pkills(monrace.r_pkills)
+        , r_akills(monrace.r_akills)
+        , r_tkills(monrace.r_tkills)
+        , r_wake(monrace.r_wake)
+        , r_ignore(monrace.r_ignore)
+        , r_can_evolve(monrace.r_can_evolve)
+        , r_drop_gold(monrace.r_drop_gold)
+        , r_drop_item(monrace.r_drop_item)
+        , r_cast_spell(monrace.r_cast_spell)
+        , r_ability_flags(monrace.r_ability_flags)
+        , r_aura_flags(monrace.r_aura_flags)
+        , r_behavior_flags(monrace.r_behavior_flags)
+        , r_kind_flags(monrace.r_kind_flags)
+        , r_resistance_flags(monrace.r_resistance_flags)
+        , r_drop_flags(monrace.r_drop_flags)
+        , r_feature_flags(monrace.r_feature_flags)
+        , r_special_flags(monrace.r_special_flags)
+        , r_misc_flags(monrace.r_misc_flags)
+        , term_wid(game_term->wid)
+        , term_hgt(game_term->hgt)
+        , size(term_get_size())
+        , offset_x(game_term->offset_x)
+        , offset_y(game_term->offset_y)
+    {
+        std::copy(std::begin(monrace.r_blows), std::end(monrace.r_blows), this->r_blows.begin());
+    }
+
+    bool operator==(const MonsterLoreState &other) const = default;
+
+private:
+    /*!
+     * @brief 思い出に破滅の手が載るかを返す
+     * @details 破滅の手の威力はプレイヤーの現在HPで決まるので、載る時だけ現在HPを状態に含める.
+     */
+    static bool is_hand_doom_known(const MonraceDefinition &monrace, monster_lore_mode mode)
+    {
+        const auto know_everything = cheat_know || (mode == MONSTER_LORE_RESEARCH) || (mode == MONSTER_LORE_DEBUG);
+        const auto &ability_flags = know_everything ? monrace.ability_flags : monrace.r_ability_flags;
+        return ability_flags.has(MonsterAbilityType::HAND_DOOM);
+    }
+};
+
+/*!
+ * @brief 描画したモンスターの思い出の1行分の画面内容
+ */
+struct MonsterLoreLine {
+    std::vector<TERM_COLOR> a;
+    std::vector<char> c;
+    std::vector<TERM_COLOR> ta;
+    std::vector<char> tc;
+};
+
+/*!
+ * @brief 描画したモンスターの思い出の画面内容
+ */
+struct MonsterLoreLayout {
+    MonsterLoreState state;
+    TERM_LEN top; //!< 描画を始めた行 (端末上の座標)
+    std::vector<MonsterLoreLine> lines;
+};
+
+std::map<MonraceId, MonsterLoreLayout> lore_layouts;
+TERM_LEN lore_bottom = 0; //!< 描画中の思い出が書き換えた最も下の行
+
+/*!
+ * @brief 書き換えた行を記録しながら c_roff() で描画する
+ * @param attr 文字色
+ * @param str 文字列
+ * @details c_roff() は改行で次の行を消去するので、その行も書き換えたものとして扱う.
+ */
+void c_roff_recording_rows(TERM_COLOR attr, std::string_view str)
+{
+    c_roff(attr, str);
+    TERM_LEN x;
+    TERM_LEN y;
+    (void)term_locate(&x, &y);
+    const auto &[wid, hgt] = term_get_size();
+    const auto bottom = (str.find('\n') != std::string_view::npos) ? std::min(y + 1, hgt - 1) : y;
+    lore_bottom = std::max(lore_bottom, bottom);
+}
+
+/*!
+ * @brief モンスターの思い出を現在のカーソル位置から c_roff() で描画する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param monrace_id モンスターの種族ID
+ * @param mode 表示オプション
+ * @details
+ * 書き換えた行の画面内容を種族毎に保持しておき、思い出・プレイヤー・端末の大きさのいずれも変わっていなければ
+ * 思い出を組み立て直さずにそのまま画面へ書き戻す.
+ * 書き換える行は全て消去してから描くので、描画結果は元の画面内容に依らない.
+ */
+void roff_monster_lore(PlayerType *player_ptr, MonraceId monrace_id, monster_lore_mode mode)
+{
+    const auto &monrace = MonraceList::get_instance().get_monrace(monrace_id);
+    MonsterLoreState state(player_ptr, monrace, mode);
+    TERM_LEN x;
+    TERM_LEN y;
+    (void)term_locate(&x, &y);
+    const auto top = y + game_term->offset_y;
+    const auto it = lore_layouts.find(monrace_id);
+    if ((it != lore_layouts.end()) && (it->second.state == state) && (it->second.top == top)) {
+        auto row = top;
+        for (auto &line : it->second.lines) {
+            term_queue_line(state.offset_x, row++, line.a.size(), line.a.data(), line.c.data(), line.ta.data(), line.tc.data());
+        }
+
+        return;
+    }
+
+    lore_bottom = y;
+    hook_c_roff = c_roff_recording_rows;
+    process_monster_lore(player_ptr, monrace_id, mode);
+    hook_c_roff = c_roff;
+    if ((it == lore_layouts.end()) && (lore_layouts.size() >= MAX_LORE_LAYOUTS)) {
+        lore_layouts.clear();
+    }
+
+    MonsterLoreLayout layout{ state, top, {} };
+    const auto &scr = game_term->scr;
+    for (auto row = top; row <= lore_bottom + state.offset_y; row++) {
+        const auto begin = state.offset_x;
+        auto &line = layout.lines.emplace_back();
+        line.a.assign(scr->a[row].begin() + begin, scr->a[row].end());
+        line.c.assign(scr->c[row].begin() + begin, scr->c[row].end());
+        line.ta.assign(scr->ta[row].begin() + begin, scr->ta[row].end());
+        line.tc.assign(scr->tc[row].begin() + begin, scr->tc[row].end());
+    }
+
+    lore_layouts.insert_or_assign(monrace_id, std::move(layout));
+}
+}
 
 /*!
  * @brief モンスター情報のヘッダを記述する
@@ -72,8 +261,7 @@ void screen_roff(PlayerType *player_ptr, MonraceId r_idx, monster_lore_mode mode
 {
     msg_erase();
     term_erase(0, 1);
-    hook_c_roff = c_roff;
-    process_monster_lore(player_ptr, r_idx, mode);
+    roff_monster_lore(player_ptr, r_idx, mode);
     roff_top(r_idx);
 }
 
@@ -96,7 +284,7 @@ void display_roff(PlayerType *player_ptr)
     }
 
     const auto monrace_id = tracker.get_trackee();
-    process_monster_lore(player_ptr, monrace_id, MONSTER_LORE_NORMAL);
+    roff_monster_lore(player_ptr, monrace_id, MONSTER_LORE_NORMAL);
     roff_top(monrace_id);
 }
 
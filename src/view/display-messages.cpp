@@ -14,11 +14,11 @@
 #include "term/gameterm.h"
 #include "term/term-color-types.h"
 #include "util/int-char-converter.h"
+#include "view/message-history.h"
 #include "world/world.h"
-#include <deque>
-#include <map>
-#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 /* Used in msg_print() for "buffering" */
 bool msg_flag;
@@ -30,58 +30,11 @@ namespace {
 /*! 表示するメッセージの先頭位置 */
 static int msg_head_pos = 0;
 
-using msg_sp = std::shared_ptr<const std::string>;
-using msg_wp = std::weak_ptr<const std::string>;
-
-/** メッセージが同一かどうかを比較するためのラムダ式 */
-auto string_ptr_cmp = [](const std::string *a, const std::string *b) { return *a < *b; };
-
-/** 同一メッセージの検索に使用するmapオブジェクト。
- * 同一メッセージがあるかどうかを検索し、ヒットしたらweak_ptrからshared_ptrを作成しメッセージを共有する。
- * message_historyのカスタムデリータの中で参照するので、message_historyより先に宣言しなければならない事に注意。
- */
-std::map<const std::string *, msg_wp, decltype(string_ptr_cmp)> message_map(string_ptr_cmp);
-
-/** メッセージ行 */
-struct msg_record {
-    msg_record(msg_sp msg, short repeat_count = 1)
-        : msg(std::move(msg))
-        , repeat_count(repeat_count)
-    {
-    }
-    msg_sp msg; //< メッセージ
-    short repeat_count; //< 繰り返し回数
-};
+/*! 表示せずに溜めておくメッセージの格納先 (MessageDeferrer の生存期間中のみ) */
+static thread_local std::vector<std::string> *deferred_messages = nullptr;
 
 /** メッセージ履歴 */
-std::deque<msg_record> message_history;
-
-/**
- * @brief メッセージを保持する msg_sp オブジェクトを生成する
- *
- * @param msg メッセージ
- * @return 生成した msg_sp オブジェクト
- */
-msg_sp make_message(std::string &&msg)
-{
-    // メッセージ履歴に同一のメッセージがあれば、そのメッセージの msg_sp オブジェクトを複製して返す
-    if (const auto &it = message_map.find(&msg); it != message_map.end()) {
-        return it->second.lock();
-    }
-
-    // 見つからなければ新たに msg_sp オブジェクトを作成する
-    /** std::stringオブジェクトと同時にmessage_mapのエントリも削除するカスタムデリータ */
-    auto deleter = [](std::string *s) {
-        message_map.erase(s);
-        delete s;
-    };
-
-    // 新たにメッセージを保持する msg_sp オブジェクトを生成し、検索用mapオブジェクトにも追加する
-    auto new_msg = msg_sp(new std::string(std::move(msg)), std::move(deleter));
-    message_map.emplace(new_msg.get(), msg_wp(new_msg));
-
-    return new_msg;
-}
+MessageHistory message_history(MESSAGE_MAX);
 }
 
 /*!
@@ -96,22 +49,33 @@ int32_t message_num(void)
 /*!
  * @brief 過去のゲームメッセージを返す。 / Recall the "text" of a saved message
  * @param age メッセージの世代
- * @return メッセージの文字列ポインタ
+ * @return メッセージの文字列 (繰り返し回数付き)
  */
-std::shared_ptr<const std::string> message_str(int age)
+std::string message_str(int age)
 {
     if ((age < 0) || (age >= message_num())) {
-        return std::make_shared<const std::string>("");
+        return "";
     }
 
-    const auto &[msg, repeat_count] = message_history[age];
-    if (repeat_count > 1) {
-        return std::make_shared<const std::string>(*msg + format(" <x%d>", repeat_count));
+    std::string msg(message_history.get_text(age));
+    if (const auto repeat_count = message_history.get_repeat_count(age); repeat_count > 1) {
+        msg.append(format(" <x%d>", repeat_count));
     }
 
     return msg;
 }
 
+/*!
+ * @brief 指定した文字列を含む過去のゲームメッセージを検索する
+ * @param age 検索を開始するメッセージの世代
+ * @param find 検索する文字列
+ * @return 見つかったメッセージの世代。見つからなければstd::nullopt
+ */
+std::optional<int> message_search(int age, std::string_view find)
+{
+    return message_history.search(age, find);
+}
+
 /*!
  * @brief メッセージ履歴にメッセージを追加する
  * @param msg 保存するメッセージ
@@ -123,11 +87,8 @@ void message_add(std::string_view msg)
     }
 
     if (!message_history.empty()) {
-        auto &last_msg = message_history.front();
-
         // 直前と同じメッセージの場合、繰り返し回数を増やして終了
-        if ((msg == *last_msg.msg) && (last_msg.repeat_count < 9999)) {
-            last_msg.repeat_count++;
+        if ((msg == message_history.get_text(0)) && message_history.increment_latest_repeat_count(9999)) {
             if (!now_message) {
                 now_message++;
             }
@@ -140,11 +101,7 @@ void message_add(std::string_view msg)
     }
 
     // メッセージ履歴に追加
-    message_history.emplace_front(make_message(std::string(msg)));
-
-    while (message_history.size() > MESSAGE_MAX) {
-        message_history.pop_back();
-    }
+    message_history.add(msg);
 }
 
 bool is_msg_window_flowed(void)
@@ -280,6 +237,11 @@ static int split_length(std::string_view sv, int max)
  */
 void msg_print(std::string_view msg)
 {
+    if (deferred_messages) {
+        deferred_messages->emplace_back(msg);
+        return;
+    }
+
     const auto &world = AngbandWorld::get_instance();
     if (world.timewalk_m_idx) {
         return;
@@ -333,7 +295,7 @@ void msg_print(std::string_view msg)
 
 void msg_print(std::nullptr_t)
 {
-    if (AngbandWorld::get_instance().timewalk_m_idx) {
+    if (deferred_messages || AngbandWorld::get_instance().timewalk_m_idx) {
         return;
     }
 
@@ -358,6 +320,21 @@ void msg_format(const char *fmt, ...)
     msg_print(buf);
 }
 
+/*!
+ * @brief このスレッドのメッセージを溜め始める
+ * @param messages 溜めたメッセージの格納先
+ */
+MessageDeferrer::MessageDeferrer(std::vector<std::string> &messages)
+    : previous_messages(deferred_messages)
+{
+    deferred_messages = &messages;
+}
+
+MessageDeferrer::~MessageDeferrer()
+{
+    deferred_messages = this->previous_messages;
+}
+
 /*!
  * @brief セーブファイルにメッセージ履歴を保存する
  */
@@ -370,9 +347,8 @@ void wr_message_history()
 
     wr_s32b(num);
     for (auto i = 0; i < num; ++i) {
-        const auto &[msg, repeat_count] = message_history[i];
-        wr_string(*msg);
-        wr_s16b(repeat_count);
+        wr_string(message_history.get_text(i));
+        wr_s16b(message_history.get_repeat_count(i));
     }
 }
 
@@ -383,12 +359,18 @@ void rd_message_history()
 {
     message_history.clear();
 
+    // セーブファイルには新しい順に保存されているので、読み込んだ後古い順に追加し直す
+    std::vector<std::pair<std::string, short>> records;
     const auto message_hisotry_num = rd_s32b();
     for (auto i = 0; i < message_hisotry_num; i++) {
         auto msg = rd_string();
         const auto repeat_count = rd_s16b();
-        if (message_history.size() < MESSAGE_MAX) {
-            message_history.emplace_back(make_message(std::move(msg)), repeat_count);
+        if (records.size() < MESSAGE_MAX) {
+            records.emplace_back(std::move(msg), repeat_count);
         }
     }
+
+    for (auto it = records.rbegin(); it != records.rend(); ++it) {
+        message_history.add(it->first, it->second);
+    }
 }
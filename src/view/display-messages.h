@@ -2,9 +2,10 @@
 
 #include "system/angband.h"
 #include <concepts>
-#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 /*
  * OPTION: Maximum number of messages to remember (see "io.c")
@@ -16,7 +17,8 @@ extern bool msg_flag;
 extern COMMAND_CODE now_message;
 
 int32_t message_num();
-std::shared_ptr<const std::string> message_str(int age);
+std::string message_str(int age);
+std::optional<int> message_search(int age, std::string_view find);
 void message_add(std::string_view msg);
 void msg_erase();
 void msg_print(std::string_view msg);
@@ -24,3 +26,20 @@ void msg_print(std::nullptr_t);
 void msg_format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
 void wr_message_history();
 void rd_message_history();
+
+/*!
+ * @brief 生存期間中、同じスレッドの msg_print() を表示せずに溜めておくクラス
+ * @details ワーカースレッドでは画面に触れないので、メッセージはメインスレッドへ持ち帰ってから表示する.
+ */
+class MessageDeferrer {
+public:
+    explicit MessageDeferrer(std::vector<std::string> &messages);
+    ~MessageDeferrer();
+    MessageDeferrer(const MessageDeferrer &) = delete;
+    MessageDeferrer &operator=(const MessageDeferrer &) = delete;
+    MessageDeferrer(MessageDeferrer &&) = delete;
+    MessageDeferrer &operator=(MessageDeferrer &&) = delete;
+
+private:
+    std::vector<std::string> *previous_messages;
+};
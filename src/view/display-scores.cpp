@@ -1,4 +1,5 @@
 #include "view/display-scores.h"
+#include "core/high-score-store.h"
 #include "core/score-util.h"
 #include "io/files-util.h"
 #include "io/input-key-acceptor.h"
@@ -15,25 +16,21 @@
 #include "util/int-char-converter.h"
 
 /*!
- * @brief 指定された順位範囲でスコアを並べて表示する / Display the scores in a given range.
+ * @brief 読み込み済みのスコアを指定された順位範囲で並べて表示する
+ * @param store スコアファイルの内容
  * @param from 順位先頭
  * @param to 順位末尾
  * @param note 黄色表示でハイライトする順位
  * @param score スコア配列参照ポインタ
  * @details
  * <pre>
- * Assumes the high score list is already open.
  * Only five entries per line, too much info.
  *
  * Mega-Hack -- allow "fake" entry at the given position.
  * </pre>
  */
-void display_scores(int from, int to, int note, high_score *score)
+static void display_scores_aux(const HighScoreStore &store, int from, int to, int note, high_score *score)
 {
-    if (highscore_fd < 0) {
-        return;
-    }
-
     if (from < 0) {
         from = 0;
     }
@@ -46,17 +43,8 @@ void display_scores(int from, int to, int note, high_score *score)
         to = MAX_HISCORES;
     }
 
-    if (highscore_seek(0)) {
-        return;
-    }
-
-    auto num_scores = 0;
+    auto num_scores = store.size();
     high_score the_score;
-    for (; num_scores < MAX_HISCORES; num_scores++) {
-        if (highscore_read(&the_score)) {
-            break;
-        }
-    }
 
     if ((note == num_scores) && score) {
         num_scores++;
@@ -84,7 +72,9 @@ void display_scores(int from, int to, int note, high_score *score)
                 score = nullptr;
                 note = -1;
                 j--;
-            } else if (highscore_seek(j) || highscore_read(&the_score)) {
+            } else if (j < store.size()) {
+                the_score = store.get_score(j);
+            } else {
                 break;
             }
 
@@ -197,6 +187,24 @@ void display_scores(int from, int to, int note, high_score *score)
     }
 }
 
+/*!
+ * @brief 指定された順位範囲でスコアを並べて表示する / Display the scores in a given range.
+ * @param from 順位先頭
+ * @param to 順位末尾
+ * @param note 黄色表示でハイライトする順位
+ * @param score スコア配列参照ポインタ
+ * @details The high score list is read from the score file at once.
+ */
+void display_scores(int from, int to, int note, high_score *score)
+{
+    const auto store = HighScoreStore::load();
+    if (!store) {
+        return;
+    }
+
+    display_scores_aux(*store, from, to, note, score);
+}
+
 #ifndef WINDOWS
 /*!
  * @brief スコア表示処理メインルーチン / Display the scores in a given range and quit.
@@ -209,17 +217,13 @@ void display_scores(int from, int to, int note, high_score *score)
  */
 void display_scores(int from, int to)
 {
-    const auto path = path_build(ANGBAND_DIR_APEX, "scores.raw");
-    const auto filename = path.string();
-    highscore_fd = fd_open(filename, O_RDONLY);
-    if (highscore_fd < 0) {
+    const auto store = HighScoreStore::load();
+    if (!store) {
         quit(_("スコア・ファイルが使用できません。", "Score file unavailable."));
     }
 
     term_clear();
-    display_scores(from, to, -1, nullptr);
-    (void)fd_close(highscore_fd);
-    highscore_fd = -1;
+    display_scores_aux(*store, from, to, -1, nullptr);
     quit("");
 }
 #endif
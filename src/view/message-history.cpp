@@ -0,0 +1,203 @@
+#include "view/message-history.h"
+#include "util/string-processor.h"
+#include <algorithm>
+
+MessageHistory::MessageHistory(size_t capacity)
+    : capacity(capacity)
+{
+}
+
+/*!
+ * @brief 保持しているメッセージの数を返す
+ * @return メッセージの数
+ */
+size_t MessageHistory::size() const
+{
+    return this->records.size();
+}
+
+bool MessageHistory::empty() const
+{
+    return this->records.empty();
+}
+
+void MessageHistory::clear()
+{
+    this->records.clear();
+    this->oldest_pos = 0;
+    this->texts.clear();
+    this->free_ids.clear();
+    this->ids.clear();
+}
+
+/*!
+ * @brief 最新のメッセージとして履歴に追加する
+ * @details 容量を超えた場合は最も古いメッセージを上書きする.
+ * @param msg メッセージ
+ * @param repeat_count 繰り返し回数
+ */
+void MessageHistory::add(std::string_view msg, short repeat_count)
+{
+    const auto id = this->intern(msg);
+    if (this->records.size() < this->capacity) {
+        this->records.push_back({ id, repeat_count });
+        return;
+    }
+
+    auto &oldest = this->records[this->oldest_pos];
+    this->release(oldest.id);
+    oldest = { id, repeat_count };
+    this->oldest_pos = (this->oldest_pos + 1) % this->records.size();
+}
+
+/*!
+ * @brief 指定した世代のメッセージ文字列を返す
+ * @param age メッセージの世代 (0が最新)
+ * @return メッセージ文字列 (繰り返し回数は含まない)
+ */
+std::string_view MessageHistory::get_text(int age) const
+{
+    return this->texts[this->get_record(age).id].text;
+}
+
+short MessageHistory::get_repeat_count(int age) const
+{
+    return this->get_record(age).repeat_count;
+}
+
+/*!
+ * @brief 最新のメッセージの繰り返し回数を1増やす
+ * @param max_count 繰り返し回数の上限
+ * @return 増やせたらtrue、履歴が空か上限に達していたらfalse
+ */
+bool MessageHistory::increment_latest_repeat_count(short max_count)
+{
+    if (this->records.empty()) {
+        return false;
+    }
+
+    auto &latest = this->get_record(0);
+    if (latest.repeat_count >= max_count) {
+        return false;
+    }
+
+    latest.repeat_count++;
+    return true;
+}
+
+/*!
+ * @brief 指定した文字列を含むメッセージを新しい方から検索する
+ * @details
+ * トライグラムのシグネチャで候補を絞り込んでから文字列照合を行う.
+ * 同じIDの照合結果は検索中に使い回すので、同一メッセージが繰り返し現れても照合は1度だけで済む.
+ * @param age_from 検索を開始する世代
+ * @param find 検索する文字列
+ * @return 見つかったメッセージの世代。見つからなければstd::nullopt
+ */
+std::optional<int> MessageHistory::search(int age_from, std::string_view find) const
+{
+    if (find.empty()) {
+        return std::nullopt;
+    }
+
+    enum class MatchState : uint8_t {
+        UNKNOWN,
+        MATCH,
+        MISMATCH,
+    };
+
+    const auto find_signature = calc_trigram_signature(find);
+    std::vector<MatchState> states(this->texts.size(), MatchState::UNKNOWN);
+    for (auto age = std::max(age_from, 0); age < std::ssize(this->records); ++age) {
+        const auto id = this->get_record(age).id;
+        auto &state = states[id];
+        if (state == MatchState::UNKNOWN) {
+            const auto &message_text = this->texts[id];
+            const auto is_candidate = (message_text.trigram_signature & find_signature) == find_signature;
+            state = (is_candidate && angband_strstr(message_text.text.data(), find) != nullptr) ? MatchState::MATCH : MatchState::MISMATCH;
+        }
+
+        if (state == MatchState::MATCH) {
+            return age;
+        }
+    }
+
+    return std::nullopt;
+}
+
+const MessageHistory::MessageRecord &MessageHistory::get_record(int age) const
+{
+    const auto num = this->records.size();
+    return this->records[(this->oldest_pos + num - 1 - age) % num];
+}
+
+MessageHistory::MessageRecord &MessageHistory::get_record(int age)
+{
+    const auto num = this->records.size();
+    return this->records[(this->oldest_pos + num - 1 - age) % num];
+}
+
+/*!
+ * @brief メッセージ文字列をインターンしてIDを得る
+ * @details 既に同じ文字列があればそのIDを共有し、なければ空きIDに新しく登録する.
+ * @param msg メッセージ
+ * @return メッセージ文字列のID
+ */
+uint32_t MessageHistory::intern(std::string_view msg)
+{
+    if (const auto it = this->ids.find(msg); it != this->ids.end()) {
+        this->texts[it->second].refcount++;
+        return it->second;
+    }
+
+    uint32_t id;
+    if (this->free_ids.empty()) {
+        id = static_cast<uint32_t>(this->texts.size());
+        this->texts.emplace_back();
+    } else {
+        id = this->free_ids.back();
+        this->free_ids.pop_back();
+    }
+
+    auto &message_text = this->texts[id];
+    message_text.text = msg;
+    message_text.trigram_signature = calc_trigram_signature(msg);
+    message_text.refcount = 1;
+    this->ids.emplace(message_text.text, id);
+    return id;
+}
+
+/*!
+ * @brief メッセージ文字列の参照を1つ解放する
+ * @details どこからも参照されなくなったら文字列を破棄し、IDを再利用可能にする.
+ * @param id メッセージ文字列のID
+ */
+void MessageHistory::release(uint32_t id)
+{
+    auto &message_text = this->texts[id];
+    if (--message_text.refcount > 0) {
+        return;
+    }
+
+    this->ids.erase(message_text.text);
+    message_text.text.clear();
+    message_text.text.shrink_to_fit();
+    this->free_ids.push_back(id);
+}
+
+/*!
+ * @brief 文字列に含まれるバイト単位のトライグラムを64bitのビット集合に畳み込む
+ * @details 部分文字列のシグネチャは元の文字列のシグネチャに必ず包含されるので、検索候補の絞り込みに使える.
+ * @param str 文字列
+ * @return シグネチャ
+ */
+uint64_t MessageHistory::calc_trigram_signature(std::string_view str)
+{
+    uint64_t signature = 0;
+    for (size_t i = 0; i + 3 <= str.size(); ++i) {
+        const auto trigram = (static_cast<uint8_t>(str[i]) << 16) | (static_cast<uint8_t>(str[i + 1]) << 8) | static_cast<uint8_t>(str[i + 2]);
+        signature |= 1ULL << ((trigram * 2654435761U) >> 26);
+    }
+
+    return signature;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * @brief メッセージ履歴を保持するクラス
+ * @details
+ * 同一のメッセージ文字列は32bitのIDで共有(インターン)し、履歴本体は (ID, 繰り返し回数) の組を
+ * 固定長のリングバッファに保持する.
+ * 各文字列にはトライグラムのシグネチャ(64bitのビット集合)を持たせ、検索時の候補絞り込みに使用する.
+ * 履歴の位置は「世代」(0が最新)で指定する.
+ */
+class MessageHistory {
+public:
+    explicit MessageHistory(size_t capacity);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+    void add(std::string_view msg, short repeat_count = 1);
+    std::string_view get_text(int age) const;
+    short get_repeat_count(int age) const;
+    bool increment_latest_repeat_count(short max_count);
+    std::optional<int> search(int age_from, std::string_view find) const;
+
+private:
+    /*! インターンされたメッセージ文字列 */
+    struct MessageText {
+        std::string text; //!< メッセージ本体
+        uint64_t trigram_signature = 0; //!< 含まれるトライグラムのシグネチャ
+        uint32_t refcount = 0; //!< 履歴中で参照されている数
+    };
+
+    /*! 履歴の1行 */
+    struct MessageRecord {
+        uint32_t id; //!< メッセージ文字列のID
+        short repeat_count; //!< 繰り返し回数
+    };
+
+    size_t capacity;
+    size_t oldest_pos = 0; //!< リングバッファ中で最も古い履歴の位置
+    std::vector<MessageRecord> records; //!< 履歴のリングバッファ (古い順)
+    std::deque<MessageText> texts; //!< IDで引くメッセージ文字列 (要素のアドレスは不変)
+    std::vector<uint32_t> free_ids; //!< 再利用可能なID
+    std::unordered_map<std::string_view, uint32_t> ids; //!< 文字列からIDへの索引 (キーはtexts内の文字列を参照する)
+
+    const MessageRecord &get_record(int age) const;
+    MessageRecord &get_record(int age);
+    uint32_t intern(std::string_view msg);
+    void release(uint32_t id);
+    static uint64_t calc_trigram_signature(std::string_view str);
+};
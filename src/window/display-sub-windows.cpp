@@ -418,7 +418,7 @@ void fix_message(void)
                 const auto color = (i < now_message) ? TERM_WHITE : TERM_SLATE;
 
                 const auto msg = message_str(i);
-                auto lines = shape_buffer(*msg, wid);
+                auto lines = shape_buffer(msg, wid);
                 std::reverse(lines.begin(), lines.end());
 
                 for (const auto &line : lines) {
@@ -0,0 +1,475 @@
+/*!
+ * @brief 画面無しでモンスターの行動を進めるシミュレーション
+ * @details
+ * ゲームデータを読み込んでシード値からフロアを生成し、決まった動きをするプレイヤーの周囲にモンスターを配置して
+ * 指定ゲームターン数だけ進め、処理毎の所要時間・メモリ確保回数・ゲームターンの処理速度を報告する.
+ * 端末は何も描画しない仮想端末を使うので、画面の無い環境でもモンスターAIや視界計算の性能を計測できる.
+ * 同じ設定なら同じ乱数列で進むので、計測結果の比較に使える.
+ */
+
+#include "wizard/headless-simulator.h"
+#include "birth/birth-body-spec.h"
+#include "birth/birth-stat.h"
+#include "birth/game-play-initializer.h"
+#include "core/object-compressor.h"
+#include "core/speed-table.h"
+#include "core/stuff-handler.h"
+#include "effect/effect-characteristics.h"
+#include "effect/effect-processor.h"
+#include "floor/cave.h"
+#include "floor/floor-base-definitions.h"
+#include "floor/floor-generator.h"
+#include "floor/geometry.h"
+#include "game-option/cheat-options.h"
+#include "game-option/input-options.h"
+#include "grid/grid.h"
+#include "monster-floor/monster-generator.h"
+#include "monster-floor/monster-summon.h"
+#include "monster/monster-compaction.h"
+#include "monster/monster-processor.h"
+#include "player-base/player-class.h"
+#include "player-info/class-info.h"
+#include "player-info/race-info.h"
+#include "player/player-move.h"
+#include "player/player-personality.h"
+#include "player/player-sex.h"
+#include "player/player-status-table.h"
+#include "player/player-status.h"
+#include "player/player-view.h"
+#include "player/race-info-table.h"
+#include "system/angband-system.h"
+#include "system/enums/dungeon/dungeon-id.h"
+#include "system/floor/floor-info.h"
+#include "system/gamevalue.h"
+#include "system/grid-type-definition.h"
+#include "system/monster-entity.h"
+#include "system/player-type-definition.h"
+#include "system/redrawing-flags-updater.h"
+#include "target/projection-path-calculator.h"
+#include "term/gameterm.h"
+#include "term/z-form.h"
+#include "term/z-rand.h"
+#include "term/z-term.h"
+#include "util/enum-converter.h"
+#include "util/int-char-converter.h"
+#include "util/string-processor.h"
+#include "world/world-turn-processor.h"
+#include "world/world.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <string>
+
+namespace {
+std::atomic<bool> is_counting_allocations = false;
+std::atomic<uint64_t> allocation_count = 0;
+
+/*!
+ * @brief 計測対象の処理
+ */
+enum class SimulationStage {
+    MONSTERS, //!< process_monsters()
+    VIEW, //!< update_view()
+    FLOW, //!< update_flow()
+    PROJECT, //!< プレイヤーの放つ project()
+    OTHER_UPDATES, //!< その他の handle_stuff()
+    WORLD, //!< process_world()
+    MAX,
+};
+
+constexpr std::array<std::string_view, enum2i(SimulationStage::MAX)> STAGE_NAMES = {
+    "process_monsters",
+    "update_view",
+    "update_flow",
+    "project",
+    "handle_stuff (other)",
+    "process_world",
+};
+
+constexpr auto PROJECT_INTERVAL = 4; //!< プレイヤーがボールを放つ間隔 (プレイヤーの行動回数)
+
+/*!
+ * @brief メモリ確保回数を表示用の文字列にする
+ * @details 確保回数を数えないビルドでは "-" とする.
+ */
+std::string describe_allocations(uint64_t count)
+{
+#ifdef COUNT_ALLOCATIONS
+    return std::to_string(count);
+#else
+    (void)count;
+    return "-";
+#endif
+}
+
+/*!
+ * @brief 処理毎の所要時間とメモリ確保回数を集計するクラス
+ */
+class SimulationProfiler {
+public:
+    template <typename F>
+    void measure(SimulationStage stage, F &&f);
+    void report(const HeadlessSimulationSettings &settings, std::chrono::steady_clock::duration elapsed) const;
+
+private:
+    struct StageProfile {
+        int calls = 0;
+        std::chrono::steady_clock::duration duration{};
+        uint64_t allocations = 0;
+    };
+
+    std::array<StageProfile, enum2i(SimulationStage::MAX)> profiles{};
+};
+
+template <typename F>
+void SimulationProfiler::measure(SimulationStage stage, F &&f)
+{
+    const auto allocations = allocation_count.load(std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    auto &profile = this->profiles[enum2i(stage)];
+    profile.calls++;
+    profile.duration += std::chrono::steady_clock::now() - start;
+    profile.allocations += allocation_count.load(std::memory_order_relaxed) - allocations;
+}
+
+/*!
+ * @brief 集計結果を標準出力に書き出す
+ * @param settings シミュレーションの設定
+ * @param elapsed シミュレーション全体の所要時間
+ */
+void SimulationProfiler::report(const HeadlessSimulationSettings &settings, std::chrono::steady_clock::duration elapsed) const
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const auto elapsed_us = duration_cast<microseconds>(elapsed).count();
+    const auto turns_per_second = elapsed_us > 0 ? settings.turns * 1000000.0 / elapsed_us : 0.0;
+    puts(format("seed %u, level %d, %d monsters, %d game turns", settings.seed, settings.dun_level, settings.monsters, settings.turns).data());
+    puts(format("total %.3f ms, %.1f turns/s, %s allocations", elapsed_us / 1000.0, turns_per_second,
+        describe_allocations(allocation_count.load(std::memory_order_relaxed)).data())
+             .data());
+    puts(format("%-22s %10s %12s %12s %12s", "stage", "calls", "total ms", "avg us", "allocations").data());
+    for (auto i = 0; i < enum2i(SimulationStage::MAX); i++) {
+        const auto &profile = this->profiles[i];
+        const auto total_us = duration_cast<microseconds>(profile.duration).count();
+        const auto average_us = profile.calls > 0 ? static_cast<double>(total_us) / profile.calls : 0.0;
+        puts(format("%-22s %10d %12.3f %12.2f %12s", STAGE_NAMES[i].data(), profile.calls, total_us / 1000.0, average_us,
+            describe_allocations(profile.allocations).data())
+                 .data());
+    }
+}
+
+/*!
+ * @brief 仮想端末の拡張機能
+ * @details 入力待ちになったら ESC を送り、確認などで止まらずに先へ進めるようにする.
+ */
+errr null_term_xtra(int n, int v)
+{
+    if ((n == TERM_XTRA_EVENT) && v) {
+        term_key_push(ESCAPE);
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief 何も描画しない仮想端末を用意する
+ */
+void init_null_term()
+{
+    static term_type null_term;
+    term_init(&null_term, MAIN_TERM_MIN_COLS, MAIN_TERM_MIN_ROWS, 256);
+    null_term.xtra_hook = null_term_xtra;
+    angband_terms[0] = &null_term;
+    term_activate(&null_term);
+}
+
+/*!
+ * @brief 入力を伴わずにプレイヤーを作成する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details 人間の戦士で固定し、能力値などはシード値から決める. 死亡しないよう cheat_immortal を有効にする.
+ * レベルアップ時の能力値選択で入力待ちにならないよう、最初から最高レベルにしておく.
+ */
+void create_player(PlayerType *player_ptr)
+{
+    player_wipe_without_name(player_ptr);
+    player_ptr->psex = SEX_MALE;
+    player_ptr->prace = PlayerRaceType::HUMAN;
+    player_ptr->pclass = PlayerClassType::WARRIOR;
+    player_ptr->ppersonality = PERSONALITY_ORDINARY;
+    sp_ptr = &sex_info[player_ptr->psex];
+    rp_ptr = &race_info[enum2i(player_ptr->prace)];
+    cp_ptr = &class_info.at(player_ptr->pclass);
+    mp_ptr = &class_magics_info[enum2i(player_ptr->pclass)];
+    ap_ptr = &personality_info[player_ptr->ppersonality];
+    PlayerClass(player_ptr).init_specific_data();
+    get_stats(player_ptr);
+    get_ahw(player_ptr);
+    get_extra(player_ptr, true);
+    get_max_stats(player_ptr);
+    init_turn(player_ptr);
+    player_ptr->lev = PY_MAX_LEVEL;
+    player_ptr->max_plv = PY_MAX_LEVEL;
+    player_ptr->exp = player_exp[PY_MAX_LEVEL - 2] * player_ptr->expfact / 100;
+    player_ptr->max_exp = player_ptr->exp;
+    player_ptr->max_max_exp = player_ptr->exp;
+    cheat_immortal = true;
+    auto_more = true;
+
+    static constexpr auto flags = {
+        StatusRecalculatingFlag::BONUS,
+        StatusRecalculatingFlag::HP,
+    };
+    RedrawingFlagsUpdater::get_instance().set_flags(flags);
+    update_creature(player_ptr);
+    player_ptr->chp = player_ptr->mhp;
+    player_ptr->csp = player_ptr->msp;
+}
+
+/*!
+ * @brief フロアを生成し、プレイヤーの周囲にモンスターを追加する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param settings シミュレーションの設定
+ */
+void create_floor(PlayerType *player_ptr, const HeadlessSimulationSettings &settings)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    floor.set_dungeon_index(DungeonId::ANGBAND);
+    floor.dun_level = settings.dun_level;
+    floor.base_level = settings.dun_level;
+    floor.monster_level = settings.dun_level;
+    floor.object_level = settings.dun_level;
+    generate_floor(player_ptr);
+    for (auto i = 0; i < settings.monsters; i++) {
+        (void)alloc_monster(player_ptr, 2, 0, summon_specific, MAX_PLAYER_SIGHT);
+    }
+
+    floor.reset_mproc();
+    floor.reset_spatial_index();
+    floor.reset_monster_turn_states();
+
+    auto &world = AngbandWorld::get_instance();
+    world.character_dungeon = true;
+    world.character_generated = true;
+    world.character_icky_depth = 0;
+    static constexpr auto flags = {
+        StatusRecalculatingFlag::VIEW,
+        StatusRecalculatingFlag::LITE,
+        StatusRecalculatingFlag::FLOW,
+        StatusRecalculatingFlag::DISTANCE,
+        StatusRecalculatingFlag::MONSTER_LITE,
+        StatusRecalculatingFlag::MONSTER_STATUSES,
+    };
+    RedrawingFlagsUpdater::get_instance().set_flags(flags);
+    handle_stuff(player_ptr);
+}
+
+/*!
+ * @brief 更新フラグに従ってプレイヤー周りの情報を更新する
+ * @details 視界と経路の更新は handle_stuff() と同じ順序で先に行い、個別に計測する.
+ */
+void update_with_profile(PlayerType *player_ptr, SimulationProfiler &profiler)
+{
+    auto &rfu = RedrawingFlagsUpdater::get_instance();
+    if (rfu.has(StatusRecalculatingFlag::VIEW) && !rfu.has(StatusRecalculatingFlag::UN_VIEW)) {
+        rfu.reset_flag(StatusRecalculatingFlag::VIEW);
+        profiler.measure(SimulationStage::VIEW, [player_ptr] { update_view(player_ptr); });
+    }
+
+    if (rfu.has(StatusRecalculatingFlag::FLOW)) {
+        rfu.reset_flag(StatusRecalculatingFlag::FLOW);
+        profiler.measure(SimulationStage::FLOW, [player_ptr] { update_flow(player_ptr); });
+    }
+
+    profiler.measure(SimulationStage::OTHER_UPDATES, [player_ptr] { handle_stuff(player_ptr); });
+}
+
+/*!
+ * @brief プレイヤーに決まった行動をさせる
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param action_count これまでの行動回数
+ * @details 一定回数毎に最寄りのモンスターへボールを放ち、それ以外は罠の無い空いたマスへ無作為に1歩動く.
+ */
+void act_scripted_player(PlayerType *player_ptr, int action_count, SimulationProfiler &profiler)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    const auto p_pos = player_ptr->get_position();
+    if ((action_count % PROJECT_INTERVAL) == 0) {
+        const auto nearest = floor.spatial_index.find_nearest_monsters(p_pos, 1);
+        if (!nearest.empty()) {
+            const auto m_pos = floor.m_list[nearest.front()].get_position();
+            if (projectable(player_ptr, p_pos, m_pos)) {
+                constexpr auto flags = PROJECT_KILL | PROJECT_ITEM | PROJECT_GRID;
+                profiler.measure(SimulationStage::PROJECT, [player_ptr, &m_pos] {
+                    (void)project(player_ptr, 0, 2, m_pos.y, m_pos.x, 50, AttributeType::FIRE, flags);
+                });
+                return;
+            }
+        }
+    }
+
+    const auto start = randint0(CCW_DD.size());
+    for (size_t i = 0; i < CCW_DD.size(); i++) {
+        const auto pos = p_pos + CCW_DD[(start + i) % CCW_DD.size()];
+        if (!in_bounds(&floor, pos.y, pos.x)) {
+            continue;
+        }
+
+        const auto &grid = floor.get_grid(pos);
+        if (grid.has_monster() || floor.is_trap(pos) || !player_can_enter(player_ptr, grid.feat, 0)) {
+            continue;
+        }
+
+        (void)move_player_effect(player_ptr, pos.y, pos.x, MPE_DONT_PICKUP);
+        return;
+    }
+}
+
+#ifdef COUNT_ALLOCATIONS
+/*!
+ * @brief 計測中のメモリ確保を数えて確保する
+ * @details 確保に失敗したら標準の operator new と同じく new_handler を呼んでやり直す.
+ */
+void *allocate(std::size_t size)
+{
+    if (is_counting_allocations.load(std::memory_order_relaxed)) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    while (true) {
+        if (auto *ptr = std::malloc(size > 0 ? size : 1)) {
+            return ptr;
+        }
+
+        const auto handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        handler();
+    }
+}
+#endif
+}
+
+#ifdef COUNT_ALLOCATIONS
+/*
+ * シミュレーション中のメモリ確保回数を数えるため、グローバルな operator new/delete を置き換える.
+ * 全ての確保に影響するので、configure --enable-allocation-count でビルドした時のみ置き換える.
+ */
+void *operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+/*!
+ * @brief コマンドライン引数からシミュレーションの設定を読み取る
+ * @param arg "--simulate" に続く文字列 ("" または "=<ターン数>[,<モンスター数>[,<シード値>[,<階層>]]]")
+ * @return 設定. 書式が誤っていればstd::nullopt
+ */
+std::optional<HeadlessSimulationSettings> parse_headless_simulation_settings(std::string_view arg)
+{
+    HeadlessSimulationSettings settings;
+    if (arg.empty()) {
+        return settings;
+    }
+
+    if (!arg.starts_with('=')) {
+        return std::nullopt;
+    }
+
+    const auto values = str_split(arg.substr(1), ',', true);
+    if (values.empty() || (values.size() > 4)) {
+        return std::nullopt;
+    }
+
+    try {
+        settings.turns = std::stoi(values[0]);
+        if (values.size() > 1) {
+            settings.monsters = std::stoi(values[1]);
+        }
+
+        if (values.size() > 2) {
+            settings.seed = static_cast<uint32_t>(std::stoul(values[2]));
+        }
+
+        if (values.size() > 3) {
+            settings.dun_level = std::stoi(values[3]);
+        }
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+
+    const auto is_valid = (settings.turns > 0) && (settings.monsters >= 0) && (settings.dun_level > 0) && (settings.dun_level < MAX_DEPTH);
+    return is_valid ? std::make_optional(settings) : std::nullopt;
+}
+
+/*!
+ * @brief 画面無しでシミュレーションを行い、計測結果を標準出力に書き出す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param settings シミュレーションの設定
+ * @details init_angband() でゲームデータを読み込んだ後に呼ぶこと.
+ */
+void run_headless_simulation(PlayerType *player_ptr, const HeadlessSimulationSettings &settings)
+{
+    init_null_term();
+    Rand_state_init();
+    AngbandSystem::get_instance().get_rng().set_state(settings.seed);
+    create_player(player_ptr);
+    create_floor(player_ptr, settings);
+    player_ptr->playing = true;
+
+    auto &floor = *player_ptr->current_floor_ptr;
+    auto &world = AngbandWorld::get_instance();
+    SimulationProfiler profiler;
+    auto action_count = 0;
+    allocation_count = 0;
+    is_counting_allocations = true;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto turn = 0; turn < settings.turns; turn++) {
+        if (floor.m_cnt + 32 > MAX_FLOOR_MONSTERS) {
+            compact_monsters(player_ptr, 64);
+        }
+
+        if (floor.o_cnt + 32 > MAX_FLOOR_ITEMS) {
+            compact_objects(player_ptr, 64);
+        }
+
+        player_ptr->energy_need -= speed_to_energy(player_ptr->pspeed);
+        if (player_ptr->energy_need <= 0) {
+            act_scripted_player(player_ptr, action_count++, profiler);
+            player_ptr->energy_need += ENERGY_NEED();
+            update_with_profile(player_ptr, profiler);
+        }
+
+        profiler.measure(SimulationStage::MONSTERS, [player_ptr] { process_monsters(player_ptr); });
+        update_with_profile(player_ptr, profiler);
+        profiler.measure(SimulationStage::WORLD, [player_ptr] { WorldTurnProcessor(player_ptr).process_world(); });
+        update_with_profile(player_ptr, profiler);
+        world.game_turn++;
+
+        // シミュレーションを続けられるよう、死亡やフロア移動は無かったことにする
+        player_ptr->is_dead = false;
+        player_ptr->leaving = false;
+        player_ptr->chp = player_ptr->mhp;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    is_counting_allocations = false;
+    profiler.report(settings, elapsed);
+}
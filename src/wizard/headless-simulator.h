@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/*!
+ * @brief 画面無しシミュレーションの設定
+ */
+struct HeadlessSimulationSettings {
+    int turns = 10000; //!< 進めるゲームターン数
+    int monsters = 100; //!< プレイヤーの周囲に追加するモンスターの数
+    uint32_t seed = 1; //!< 乱数シード
+    int dun_level = 30; //!< 生成するダンジョンの階層
+};
+
+class PlayerType;
+std::optional<HeadlessSimulationSettings> parse_headless_simulation_settings(std::string_view arg);
+void run_headless_simulation(PlayerType *player_ptr, const HeadlessSimulationSettings &settings);